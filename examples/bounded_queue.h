@@ -0,0 +1,59 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+// Queue of at most capacity items handed from producer threads to consumer threads. push() blocks while the queue is
+// full, so producers can't run far ahead of the consumers. pop() blocks while it is empty, and gives nullopt once the
+// queue is closed and drained
+template <typename T>
+class BoundedQueue {
+  std::mutex mutex;
+  std::condition_variable not_full;
+  std::condition_variable not_empty;
+  std::deque<T> items;
+  std::size_t capacity;
+  bool closed = false;
+
+public:
+  explicit BoundedQueue(const std::size_t capacity) : capacity{capacity} {}
+
+  BoundedQueue(const BoundedQueue &) = delete;
+  auto operator=(const BoundedQueue &) -> BoundedQueue & = delete;
+
+  void push(T item) {
+    {
+      std::unique_lock lock{mutex};
+      not_full.wait(lock, [this] { return items.size() < capacity; });
+      items.push_back(std::move(item));
+    }
+    not_empty.notify_one();
+  }
+
+  auto pop() -> std::optional<T> {
+    std::optional<T> item;
+    {
+      std::unique_lock lock{mutex};
+      not_empty.wait(lock, [this] { return !items.empty() || closed; });
+      if(items.empty()) return std::nullopt;
+
+      item = std::move(items.front());
+      items.pop_front();
+    }
+    not_full.notify_one();
+    return item;
+  }
+
+  // No more pushes, consumers waiting on an empty queue are woken up
+  void close() {
+    {
+      std::lock_guard lock{mutex};
+      closed = true;
+    }
+    not_empty.notify_all();
+  }
+};
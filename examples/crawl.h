@@ -0,0 +1,99 @@
+#pragma once
+
+#include "bounded_queue.h"
+
+#include <feelelf/archive.h>
+#include <feelelf/cache.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <set>
+#include <span>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+// Reads the first bytes of a file into start, unbuffered so that nothing more is read. False if the file is shorter
+inline auto readStart(const std::filesystem::path &p, std::span<feelelf::Elf_byte> start) -> bool {
+  std::FILE *file = std::fopen(p.string().c_str(), "rb");
+  if(!file) return false;
+  std::setvbuf(file, nullptr, _IONBF, 0);
+
+  const bool read = std::fread(start.data(), 1, start.size(), file) == start.size();
+  std::fclose(file);
+  return read;
+}
+
+// Walks the directories given and those below them, and pushes every ELF file found into a queue so the files are
+// decoded while the walk goes on. Symbolic links are followed, and a directory already walked is skipped, so link loops
+// end. A file is given once however many hard or symbolic links lead to it. ELF files and archives are told by their
+// first 8 bytes, nothing else of the files is read. Files given by name are pushed as they are
+class Crawler {
+  BoundedQueue<std::filesystem::path> &found;
+  std::set<std::pair<std::uint64_t, std::uint64_t>> seen; // device and inode of directories walked and files found
+
+  // Whether the entry is met for the first time. Without device and inode numbers, symbolic links are taken as seen so
+  // link loops still end
+  auto firstSeen(const std::filesystem::directory_entry &entry) -> bool {
+    const auto key = feelelf::fileKey(entry.path().string().c_str());
+    if(!key) {
+      std::error_code ec;
+      return !entry.is_symlink(ec);
+    }
+    return seen.emplace(key->device, key->inode).second;
+  }
+
+  static auto isElfOrArchive(const std::filesystem::path &p) -> bool {
+    constexpr std::array<feelelf::Elf_byte, 4> elf_magic{0x7f, 'E', 'L', 'F'};
+    std::array<feelelf::Elf_byte, feelelf::Archive::magic_size> start{};
+    if(!readStart(p, start)) return false;
+    return std::ranges::equal(std::span{start}.first(elf_magic.size()), elf_magic) || feelelf::isArchive(start);
+  }
+
+  // Depth first, one directory open at a time
+  void walk(const std::filesystem::path &root) {
+    std::vector<std::filesystem::path> directories{root}; // left to walk, the next one last
+    std::vector<std::filesystem::path> below;
+
+    while(!directories.empty()) {
+      const auto directory = std::move(directories.back());
+      directories.pop_back();
+
+      below.clear();
+      std::error_code ec;
+      std::filesystem::directory_iterator it{directory, std::filesystem::directory_options::skip_permission_denied, ec};
+      for(const std::filesystem::directory_iterator end; !ec && it != end; it.increment(ec)) {
+        const auto &entry = *it;
+        std::error_code type_ec; // entries gone or dangling links are skipped
+        if(entry.is_directory(type_ec)) {
+          if(firstSeen(entry)) below.push_back(entry.path());
+        }
+        else if(entry.is_regular_file(type_ec) && isElfOrArchive(entry.path()) && firstSeen(entry))
+          found.push(entry.path());
+      }
+      directories.insert(directories.end(), below.rbegin(), below.rend());
+    }
+  }
+
+public:
+  explicit Crawler(BoundedQueue<std::filesystem::path> &found) : found{found} {}
+
+  // Closes the queue once every path is walked
+  void crawl(std::span<const std::filesystem::path> paths) {
+    for(const auto &p : paths) {
+      std::error_code ec;
+      const std::filesystem::directory_entry entry{p, ec};
+      if(entry.is_directory(ec)) {
+        if(firstSeen(entry)) walk(p);
+      }
+      else {
+        firstSeen(entry);
+        found.push(p);
+      }
+    }
+    found.close();
+  }
+};
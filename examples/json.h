@@ -0,0 +1,104 @@
+#pragma once
+
+#include "writer.h"
+
+#include <fmt/format.h>
+
+#include <concepts>
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+// Streaming JSON encoder, values go to the writer as soon as they are given. All it keeps is whether each open object
+// or array has a member already, so memory use doesn't grow with the amount of output. Strings are escaped, bytes
+// outside ASCII are passed through as they are
+class JsonEncoder {
+  Writer &out;
+  std::vector<bool> has_members; // one per open object and array, innermost last
+  bool after_key = false;
+
+  // A comma before every member but the first, nothing between a key and its value
+  void separate() {
+    if(after_key) {
+      after_key = false;
+      return;
+    }
+    if(has_members.empty()) return;
+    if(has_members.back()) out.write(",");
+    has_members.back() = true;
+  }
+
+  void string(std::string_view text) {
+    out.write("\"");
+    std::size_t run = 0; // start of the bytes that need no escaping
+    for(std::size_t i = 0; i != text.size(); ++i) {
+      const auto c = static_cast<unsigned char>(text[i]);
+      if(c >= 0x20 && c != '"' && c != '\\') continue;
+
+      out.write(text.substr(run, i - run));
+      if(c == '"') out.write("\\\"");
+      else if(c == '\\') out.write("\\\\");
+      else if(c == '\n') out.write("\\n");
+      else out.print("\\u{:04x}", c);
+      run = i + 1;
+    }
+    out.write(text.substr(run));
+    out.write("\"");
+  }
+
+public:
+  explicit JsonEncoder(Writer &out) : out{out} {}
+
+  void beginObject() {
+    separate();
+    out.write("{");
+    has_members.push_back(false);
+  }
+
+  void endObject() {
+    out.write("}");
+    has_members.pop_back();
+  }
+
+  void beginArray() {
+    separate();
+    out.write("[");
+    has_members.push_back(false);
+  }
+
+  void endArray() {
+    out.write("]");
+    has_members.pop_back();
+  }
+
+  void key(std::string_view name) {
+    separate();
+    string(name);
+    out.write(":");
+    after_key = true;
+  }
+
+  void value(std::string_view text) {
+    separate();
+    string(text);
+  }
+
+  // Only an actual bool, a string literal would convert to one
+  void value(std::same_as<bool> auto flag) {
+    separate();
+    out.write(flag ? "true" : "false");
+  }
+
+  template <std::integral T>
+    requires(!std::same_as<T, bool>)
+  void value(T number) {
+    separate();
+    const fmt::format_int text{number};
+    out.write({text.data(), text.size()});
+  }
+
+  void field(std::string_view name, const auto &value) {
+    key(name);
+    this->value(value);
+  }
+};
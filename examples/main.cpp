@@ -1,3 +1,11 @@
+#include "crawl.h"
+#include "json.h"
+#include "symbolize.h"
+#include "thread_pool.h"
+#include "writer.h"
+
+#include <feelelf/archive.h>
+#include <feelelf/cache.h>
 #include <feelelf/feelelf.h>
 
 #include <CLI/CLI.hpp>
@@ -5,293 +13,950 @@
 #include <fmt/core.h>
 #include <fmt/ranges.h>
 
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
 #include <filesystem>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
 #include <vector>
 
-int main(int argc, const char *argv[]) {
-  namespace fs = std::filesystem;
-  using namespace fmt::literals;
+namespace {
 
-  std::vector<fs::path> elf_files;
+namespace fs = std::filesystem;
 
+struct Options {
   bool show_fileheader = false;
   bool show_segments = false;
   bool show_sections = false;
   bool show_symbols = false;
   bool show_dynamic_symbols = false;
-  bool show_headers = false;
   bool show_notes = false;
+  bool show_dynamic = false;
   bool show_relocations = false;
+  bool triage = false;
+  bool show_file_names = false; // "File: " ahead of every text report
+
+  enum class Output { text, json, ndjson } output = Output::text;
+};
+
+// What one report is about, a file or a member of an archive
+struct Target {
+  fs::path path;                                     // of the file, or of the archive holding the member
+  std::size_t file = 0;                              // index of path among the files given
+  std::shared_ptr<const feelelf::Archive> archive{}; // mapped once for the reports of all its members
+  feelelf::Archive_Member_t member{};
+
+  // Members are named "libfoo.a(foo.o)", as readelf does
+  [[nodiscard]] auto name() const -> std::string {
+    if(!archive) return path.string();
+    return fmt::format("{}({})", path.string(), member.name);
+  }
 
-  CLI::App app{{}, "readelf"};
-  try {
-    app.set_help_flag("-H, --help", "Display this information");
-    app.set_version_flag("-v,--version", "readelf version: 0.0.1", "Display version number of feelelf");
+  [[nodiscard]] auto exists() const -> bool {
+    return archive || fs::exists(path);
+  }
 
-    app.add_flag("-h,--file-header", show_fileheader, "Display the ELF file header");
+  // Members of thin archives are files of their own, next to the archive
+  [[nodiscard]] auto open(feelelf::FileHeader &header) const -> bool {
+    if(!archive) return header.open(path.string().c_str());
+    if(archive->isThin()) return header.open((path.parent_path() / member.name).string().c_str());
+    return header.open(member.contents);
+  }
 
-    app.add_flag("-l,--program-headers", show_segments, "Display the ELF file header");
-    app.add_flag("--segments", show_segments, "An alias for --program-headers");
+  [[nodiscard]] auto probe() const -> std::optional<feelelf::Probe_t> {
+    if(!archive) return feelelf::probe(path.string().c_str());
+    if(archive->isThin()) return feelelf::probe((path.parent_path() / member.name).string().c_str());
+    return feelelf::probe(member.contents);
+  }
+};
+
+// Records of one file for --output=json and --output=ndjson. In json a file is one object, holding an array of records
+// for every kind shown. In ndjson every record is an object on its own line, naming its file and kind
+class Records {
+  Writer &out;
+  JsonEncoder json;
+  std::string_view file;
+  std::string_view kind; // of the records in the current group
+  bool ndjson;
+
+public:
+  Records(Writer &out, std::string_view file, bool ndjson) : out{out}, json{out}, file{file}, ndjson{ndjson} {
+    if(ndjson) return;
+    json.beginObject();
+    json.field("file", file);
+  }
 
-    app.add_flag("-S,--section-headers", show_sections, "Display the sections' header");
-    app.add_flag("--sections", show_sections, "An alias for --section-headers");
+  ~Records() {
+    if(!ndjson) json.endObject();
+  }
 
-    app.add_flag("-s,--syms", show_symbols, "Display the symbol table");
-    app.add_flag("--symbols", show_symbols, "An alias for --syms");
-    app.add_flag("--dyn-syms", show_dynamic_symbols, "Display the dynamic symbol table");
-    app.add_flag("-n,--notes", show_notes, "Display the core notes (if present)");
-    app.add_flag("-r,--relocs", show_relocations, "Display the relocations (if present)");
+  Records(const Records &) = delete;
+  auto operator=(const Records &) -> Records & = delete;
 
-    app.add_flag("-e,--headers", show_headers, "Equivalent to: -h -l -s");
+  void beginGroup(std::string_view name, std::string_view record_kind) {
+    kind = record_kind;
+    if(ndjson) return;
+    json.key(name);
+    json.beginArray();
+  }
 
-    app.add_option("elf-file(s)", elf_files)->option_text(" ... ");
+  void endGroup() {
+    if(!ndjson) json.endArray();
+  }
 
-    app.parse(argc, argv);
+  // A record of the current group, or when given a kind, a record standing alone
+  void beginRecord(std::string_view single = {}) {
+    if(ndjson) {
+      json.beginObject();
+      json.field("file", file);
+      json.field("record", single.empty() ? kind : single);
+      return;
+    }
+    if(!single.empty()) json.key(single);
+    json.beginObject();
   }
-  catch(CLI::ParseError &e) {
-    return app.exit(e);
+
+  void endRecord() {
+    json.endObject();
+    if(ndjson) out.write("\n");
   }
 
-  if(show_headers) {
-    show_fileheader = show_segments = show_sections = true;
+  void field(std::string_view name, const auto &value) {
+    json.field(name, value);
+  }
+
+  void error(std::string_view message) {
+    beginRecord("error");
+    field("message", message);
+    endRecord();
+  }
+};
+
+// Same selection of tables as report(), as records. Names, types and flags are the strings the text report shows,
+// numbers are plain JSON numbers
+void reportJson(const Target &target, const Options &options, Writer &out) {
+  const auto name = target.name();
+  Records records{out, name, options.output == Options::Output::ndjson};
+
+  if(!target.exists()) {
+    records.error("No such file");
+    return;
   }
 
   feelelf::FileHeader header;
+  if(!target.open(header)) {
+    records.error("Not an ELF file");
+    return;
+  }
+
+  header.decode();
+
+  if(options.show_fileheader) {
+    records.beginRecord("header");
+    records.field("class", header.fileClass());
+    records.field("data", header.fileDataEncoding());
+    records.field("version", header.fileVersion());
+    records.field("os_abi", header.osABI());
+    records.field("abi_version", header.ABIVersion());
+    records.field("type", header.type());
+    records.field("machine", header.machine());
+    records.field("entry", header.entryPoint());
+    records.field("program_header_offset", header.programHeaderOffset());
+    records.field("section_header_offset", header.sectionHeaderOffset());
+    records.field("flags", header.flags());
+    records.field("header_size", header.headerSize());
+    records.field("program_header_size", header.programHeaderSize());
+    records.field("program_headers", header.numProgramHeaders());
+    records.field("section_header_size", header.sectionHeaderEntrySize());
+    records.field("section_headers", header.numSectionHeaders());
+    records.field("section_header_string_index", header.sectionHeaderStringTableIndex());
+    records.endRecord();
+  }
+
+  header.visit([&]<typename Elf>(const Elf &elf) {
+    if(options.show_segments) {
+      records.beginGroup("segments", "segment");
+      for(const auto ph : elf.programHeaders()) {
+        records.beginRecord();
+        records.field("type", feelelf::getProgramHeaderType(ph.type));
+        records.field("offset", ph.offset);
+        records.field("vaddr", ph.vaddr);
+        records.field("paddr", ph.paddr);
+        records.field("filesz", ph.filesz);
+        records.field("memsz", ph.memsz);
+        records.field("flags", feelelf::getProgramHeaderFlag(ph.flags));
+        records.field("align", ph.align);
+        records.endRecord();
+      }
+      records.endGroup();
+    }
+
+    if(options.show_sections) {
+      records.beginGroup("sections", "section");
+      for(int i = 0; const auto sh : elf.sectionHeaders()) {
+        records.beginRecord();
+        records.field("index", i++);
+        records.field("name", elf.sectionName(sh));
+        records.field("type", feelelf::getSectionHeaderType(sh.type));
+        records.field("address", sh.addr);
+        records.field("offset", sh.offset);
+        records.field("size", sh.size);
+        records.field("entsize", sh.entsize);
+        records.field("flags", feelelf::getSectionHeaderFlag(sh.flags));
+        records.field("link", sh.link);
+        records.field("info", sh.info);
+        records.field("align", sh.addralign);
+        records.endRecord();
+      }
+      records.endGroup();
+    }
+
+    const auto symbols = [&](std::string_view table, const auto &entries, const auto &name_of) {
+      for(int i = 0; const auto sym : entries) {
+        records.beginRecord();
+        records.field("table", table);
+        records.field("index", i++);
+        records.field("name", name_of(sym));
+        records.field("value", sym.value);
+        records.field("size", sym.size);
+        records.field("type", feelelf::getSymbolType(sym.info));
+        records.field("bind", feelelf::getSymbolBind(sym.info));
+        records.field("visibility", feelelf::getSymbolVisibility(sym.other));
+        records.field("shndx", sym.shndx);
+        records.endRecord();
+      }
+    };
+
+    if(options.show_symbols || options.show_dynamic_symbols) {
+      records.beginGroup("symbols", "symbol");
+      if(options.show_symbols)
+        symbols(".symtab", elf.symbolTable(), [&](const auto &sym) { return elf.symbolName(sym); });
+      if(options.show_dynamic_symbols)
+        symbols(".dynsym", elf.dynamicSymbolTable(), [&](const auto &sym) { return elf.dynamicSymbolName(sym); });
+      records.endGroup();
+    }
+  });
+
+  if(options.show_notes) {
+    records.beginGroup("notes", "note");
+    std::string desc;
+    for(const auto &notes : header.notes()) {
+      for(const auto &note : notes) {
+        desc.clear();
+        fmt::format_to(std::back_inserter(desc), "{:02x}", fmt::join(note.desc, ""));
+
+        records.beginRecord();
+        records.field("section", notes.name()); // empty for a PT_NOTE segment
+        records.field("owner", note.name);
+        records.field("type", note.type);
+        records.field("type_name", feelelf::getNoteType(note.name, note.type));
+        records.field("desc", desc); // hex, the build ID for NT_GNU_BUILD_ID
+        records.endRecord();
+      }
+    }
+    records.endGroup();
+  }
 
-  for(const auto &p : elf_files) {
-    if(!fs::exists(p)) {
-      fmt::print("readelf: Error: '{}': No such file\n", p.string().c_str());
-      continue;
+  if(options.show_dynamic) {
+    records.beginGroup("dynamic", "dynamic");
+    for(const auto &[tag, value, name] : header.dynamic()) {
+      records.beginRecord();
+      records.field("tag", tag);
+      records.field("type", feelelf::getDynamicTag(tag));
+      records.field("value", value);
+      if(!name.empty()) records.field("name", name);
+      records.endRecord();
     }
+    records.endGroup();
+  }
 
-    bool is_good = header.open(p.string().c_str());
+  if(options.show_relocations) {
+    records.beginGroup("relocations", "relocation");
+    for(const auto &section : header.relocationTables()) {
+      for(const auto rel : section) {
+        records.beginRecord();
+        records.field("section", section.name());
+        records.field("offset", rel.offset);
+        records.field("info", rel.info);
+        records.field("type", rel.type);
+        records.field("symbol", rel.symbol);
+        if(rel.symbol != 0) {
+          records.field("symbol_value", rel.symbol_value);
+          records.field("symbol_name", rel.symbol_name);
+        }
+        if(section.hasAddend()) records.field("addend", rel.addend);
+        records.endRecord();
+      }
+    }
 
-    if(!is_good) {
-      fmt::print("readelf: Error: Not an ELF file - it has the wrong magic bytes at the start\n");
-      continue;
+    // Packed relative relocations carry nothing but the place they patch
+    for(const auto &section : header.relativeRelocationTables()) {
+      for(const auto offset : section) {
+        records.beginRecord();
+        records.field("section", section.name());
+        records.field("offset", offset);
+        records.endRecord();
+      }
     }
+    records.endGroup();
+  }
+}
 
-    header.decode();
-
-    if(show_fileheader) {
-      fmt::print("ELF Header:\n");
-      fmt::print("  {:<8} {:02x}\n", "Magic:", fmt::join(header.identificationArray(), " "));
-      fmt::print("  {:<34} {}\n", "Class:", header.fileClass());
-      fmt::print("  {:<34} {}\n", "Data:", header.fileDataEncoding());
-      fmt::print("  {:<34} {}\n", "Version:", header.fileVersion());
-      fmt::print("  {:<34} {}\n", "OS/ABI:", header.osABI());
-      fmt::print("  {:<34} {}\n", "ABI Version:", header.ABIVersion());
-      fmt::print("  {:<34} {}\n", "Type:", header.type());
-      fmt::print("  {:<34} {}\n", "Machine:", header.machine());
-      fmt::print("  {:<34} {:#x}\n", "Version:", header.version());
-      fmt::print("  {:<34} {:#x}\n", "Entry point address:", header.entryPoint());
-      fmt::print("  {:<34} {}\n", "Start of program headers:", header.programHeaderOffset());
-      fmt::print("  {:<34} {}\n", "Start of section headers:", header.sectionHeaderOffset());
-      fmt::print("  {:<34} {:#x}\n", "Flags:", header.flags());
-      fmt::print("  {:<34} {} (bytes)\n", "Size of this header:", header.headerSize());
-      fmt::print("  {:<34} {} (bytes)\n", "Size of program headers:", header.programHeaderSize());
-      fmt::print("  {:<34} {}\n", "Number of program headers:", header.numProgramHeaders());
-      fmt::print("  {:<34} {} (bytes)\n", "Size of section headers:", header.sectionHeaderEntrySize());
-      fmt::print("  {:<34} {}\n", "Number of section headers:", header.numSectionHeaders());
-      fmt::print("  {:<34} {}\n\n", "Section header string table index:", header.sectionHeaderStringTableIndex());
+// --triage, one line or record per file from what feelelf::probe() read of its headers
+void reportTriage(std::string_view name, const std::optional<feelelf::Probe_t> &probe, const Options &options,
+                  Writer &out) {
+  if(options.output != Options::Output::text) {
+    Records records{out, name, options.output == Options::Output::ndjson};
+    if(!probe) {
+      records.error("Not an ELF file or can't be read");
+      return;
     }
 
-    if(show_segments) {
-      if(!show_fileheader) {
-        fmt::print("\nElf file type is {}\n", header.fileClass());
-        fmt::print("Entry point {:#x}\n", header.entryPoint());
-        fmt::print("There are {} program headers, starting at offset {}\n\n", header.numProgramHeaders(),
-                   header.programHeaderOffset());
+    records.beginRecord("triage");
+    records.field("class", probe->file_class);
+    records.field("data", probe->data_encoding);
+    records.field("os_abi", probe->os_abi);
+    records.field("type", probe->type);
+    records.field("machine", probe->machine);
+    records.field("pie", probe->pie);
+    records.field("stripped", probe->stripped);
+    records.endRecord();
+    return;
+  }
+
+  if(!probe) {
+    out.print("{}: not an ELF file or can't be read\n", name);
+    return;
+  }
+
+  out.print("{}: {} {}, {}, {}, {}{}, {}\n", name, probe->file_class, probe->big_endian ? "MSB" : "LSB",
+            probe->type, probe->machine, probe->os_abi, probe->pie ? ", PIE" : "",
+            probe->stripped ? "stripped" : "not stripped");
+}
+
+// Formats the whole report of one file into out, so reports produced on different threads can be written in order
+void report(const Target &target, const Options &options, Writer &out) {
+  using namespace fmt::literals;
+
+  if(options.triage) {
+    reportTriage(target.name(), target.probe(), options, out);
+    return;
+  }
+
+  if(options.output != Options::Output::text) {
+    reportJson(target, options, out);
+    return;
+  }
+
+  if(!target.exists()) {
+    out.print("readelf: Error: '{}': No such file\n", target.path.string());
+    return;
+  }
+
+  // Reports are named when there are several of them, as readelf does
+  if(target.archive || options.show_file_names) out.print("\nFile: {}\n", target.name());
+
+  feelelf::FileHeader header;
+
+  if(!target.open(header)) {
+    out.print("readelf: Error: Not an ELF file - it has the wrong magic bytes at the start\n");
+    return;
+  }
+
+  header.decode();
+
+  if(options.show_fileheader) {
+    out.print("ELF Header:\n");
+    out.print("  {:<8} {:02x}\n", "Magic:", fmt::join(header.identificationArray(), " "));
+    out.print("  {:<34} {}\n", "Class:", header.fileClass());
+    out.print("  {:<34} {}\n", "Data:", header.fileDataEncoding());
+    out.print("  {:<34} {}\n", "Version:", header.fileVersion());
+    out.print("  {:<34} {}\n", "OS/ABI:", header.osABI());
+    out.print("  {:<34} {}\n", "ABI Version:", header.ABIVersion());
+    out.print("  {:<34} {}\n", "Type:", header.type());
+    out.print("  {:<34} {}\n", "Machine:", header.machine());
+    out.print("  {:<34} {:#x}\n", "Version:", header.version());
+    out.print("  {:<34} {:#x}\n", "Entry point address:", header.entryPoint());
+    out.print("  {:<34} {}\n", "Start of program headers:", header.programHeaderOffset());
+    out.print("  {:<34} {}\n", "Start of section headers:", header.sectionHeaderOffset());
+    out.print("  {:<34} {:#x}\n", "Flags:", header.flags());
+    out.print("  {:<34} {} (bytes)\n", "Size of this header:", header.headerSize());
+    out.print("  {:<34} {} (bytes)\n", "Size of program headers:", header.programHeaderSize());
+    out.print("  {:<34} {}\n", "Number of program headers:", header.numProgramHeaders());
+    out.print("  {:<34} {} (bytes)\n", "Size of section headers:", header.sectionHeaderEntrySize());
+    out.print("  {:<34} {}\n", "Number of section headers:", header.numSectionHeaders());
+    out.print("  {:<34} {}\n\n", "Section header string table index:", header.sectionHeaderStringTableIndex());
+  }
+
+  // The class and byte order are dispatched on once, the table walks below are compiled for each kind of file
+  header.visit([&]<typename Elf>(const Elf &elf) {
+    if(options.show_segments) {
+      if(!options.show_fileheader) {
+        out.print("\nElf file type is {}\n", header.fileClass());
+        out.print("Entry point {:#x}\n", header.entryPoint());
+        out.print("There are {} program headers, starting at offset {}\n\n", header.numProgramHeaders(),
+                  header.programHeaderOffset());
       }
-      fmt::print("Program Headers:\n");
+      out.print("Program Headers:\n");
       if(!header.programHeaders().empty()) {
 
-        if(header.fileClass() == "ELF32") {
-          fmt::print("{:^14} {:^8} {:^10} {:^10} {:^7} {:^7} {:^6} {:<8}\n", "Type", "Offset", "VirtAddr", "PhysAddr",
-                     "FileSiz", "MemSiz", "Flags", "Align");
+        if constexpr(!Elf::is_64bit) {
+          out.print("{:^14} {:^8} {:^10} {:^10} {:^7} {:^7} {:^6} {:<8}\n", "Type", "Offset", "VirtAddr", "PhysAddr",
+                    "FileSiz", "MemSiz", "Flags", "Align");
 
-          for(const auto &o : header.programHeaders()) {
-            const auto &x86 = std::get<feelelf::Elf32_Program_Header_t>(o);
-            fmt::print("{:<14} {:#08x} {:#010x} {:#010x} {:#07x} {:#07x} {:<6} {:#0x}\n",
-                       feelelf::getProgramHeaderType(x86.type), x86.offset, x86.vaddr, x86.paddr, x86.filesz, x86.memsz,
-                       feelelf::getProgramHeaderFlag(x86.flags), x86.align);
+          for(const auto x86 : elf.programHeaders()) {
+            out.print("{:<14} {:#08x} {:#010x} {:#010x} {:#07x} {:#07x} {:<6} {:#0x}\n",
+                      feelelf::getProgramHeaderType(x86.type), x86.offset, x86.vaddr, x86.paddr, x86.filesz, x86.memsz,
+                      feelelf::getProgramHeaderFlag(x86.flags), x86.align);
           }
         }
 
         else {
 
-          fmt::print("{:^14} {:^16} {:^16} {:^16} {:^16} {:^16} {:<7} {:<8}\n", "Type", "Offset", "VirtAddr",
-                     "PhysAddr", "FileSize", "MemSize", "Flags", "Align");
+          out.print("{:^14} {:^16} {:^16} {:^16} {:^16} {:^16} {:<7} {:<8}\n", "Type", "Offset", "VirtAddr",
+                    "PhysAddr", "FileSize", "MemSize", "Flags", "Align");
 
-          for(const auto &o : header.programHeaders()) {
-            auto x64 = std::get<feelelf::Elf64_Program_Header_t>(o);
-            fmt::print("{:<14} {:#016x} {:#016x} {:#016x} {:#016x} {:#016x} {:<7} {:#0x}\n",
-                       feelelf::getProgramHeaderType(x64.type), x64.offset, x64.vaddr, x64.paddr, x64.filesz, x64.memsz,
-                       feelelf::getProgramHeaderFlag(x64.flags), x64.align);
+          for(const auto x64 : elf.programHeaders()) {
+            out.print("{:<14} {:#016x} {:#016x} {:#016x} {:#016x} {:#016x} {:<7} {:#0x}\n",
+                      feelelf::getProgramHeaderType(x64.type), x64.offset, x64.vaddr, x64.paddr, x64.filesz, x64.memsz,
+                      feelelf::getProgramHeaderFlag(x64.flags), x64.align);
           }
         }
       }
     }
 
-    if(show_sections) {
-      fmt::print("\nThere are {} section headers, starting at offset {:#0x}:\n\n", header.numSectionHeaders(),
-                 header.sectionHeaderOffset());
+    if(options.show_sections) {
+      out.print("\nThere are {} section headers, starting at offset {:#0x}:\n\n", header.numSectionHeaders(),
+                header.sectionHeaderOffset());
 
-      fmt::print("Section Headers:\n");
+      out.print("Section Headers:\n");
 
-      if(header.fileClass() == "ELF32") {
-        fmt::print("  {} {:<18} {:<15} {:<8} {:<6} {:<6} {:<9} {:<5} {:<4} {:<4} {}\n", "[Nr]", "Name", "Type",
-                   "Address", "Offset", "Size", "EntrySize", "Flags", "Link", "Info", "Align");
+      if constexpr(!Elf::is_64bit) {
+        out.print("  {} {:<18} {:<15} {:<8} {:<6} {:<6} {:<9} {:<5} {:<4} {:<4} {}\n", "[Nr]", "Name", "Type",
+                  "Address", "Offset", "Size", "EntrySize", "Flags", "Link", "Info", "Align");
 
-        for(int i = 0; const auto &[name, section] : header.sectionHeaders()) {
-          const auto &x86 = std::get<feelelf::Elf32_Section_Header_t>(section);
-          fmt::print("  [{num:>2}] {name:<18} {type:<15} {address:>08x} {offset:>06x} {size:>06x} "
-                     "{entrySize:<9x} {flags:<5} {link:<4} {info:<4} {align}\n",
-                     "num"_a = i++, "name"_a = name, "type"_a = feelelf::getSectionHeaderType(x86.type),
-                     "address"_a = x86.addr, "offset"_a = x86.offset, "size"_a = x86.size, "entrySize"_a = x86.entsize,
-                     "flags"_a = feelelf::getSectionHeaderFlag(x86.flags), "link"_a = x86.link, "info"_a = x86.info,
-                     "align"_a = x86.addralign);
+        for(int i = 0; const auto x86 : elf.sectionHeaders()) {
+          out.print("  [{num:>2}] {name:<18} {type:<15} {address:>08x} {offset:>06x} {size:>06x} "
+                    "{entrySize:<9x} {flags:<5} {link:<4} {info:<4} {align}\n",
+                    "num"_a = i++, "name"_a = elf.sectionName(x86), "type"_a = feelelf::getSectionHeaderType(x86.type),
+                    "address"_a = x86.addr, "offset"_a = x86.offset, "size"_a = x86.size, "entrySize"_a = x86.entsize,
+                    "flags"_a = feelelf::getSectionHeaderFlag(x86.flags), "link"_a = x86.link, "info"_a = x86.info,
+                    "align"_a = x86.addralign);
         }
 
       } else {
-        fmt::print("  {} {:<18} {:<15} {:<16} {:<8} {:<16} {:<16} {:<5} {:<4} {:<4} {}\n", //
-                   "[Nr]", "Name", "Type", "Address", "Offset", "Size", "EntrySize", "Flags", "Link", "Info", "Align");
-
-        for(int i = 0; const auto &[name, section] : header.sectionHeaders()) {
-          const auto &x64 = std::get<feelelf::Elf64_Section_Header_t>(section);
-          fmt::print("  [{num:>2}] {name:<18} {type:<15} {address:>016x} {offset:>08x} {size:>016x} "
-                     "{entrySize:>016x} {flags:<5} {link:<4} {info:<4} {align}\n",
-                     "num"_a = i++, "name"_a = name, "type"_a = feelelf::getSectionHeaderType(x64.type),
-                     "address"_a = x64.addr, "offset"_a = x64.offset, "size"_a = x64.size, "entrySize"_a = x64.entsize,
-                     "flags"_a = feelelf::getSectionHeaderFlag(x64.flags), "link"_a = x64.link, "info"_a = x64.info,
-                     "align"_a = x64.addralign);
+        out.print("  {} {:<18} {:<15} {:<16} {:<8} {:<16} {:<16} {:<5} {:<4} {:<4} {}\n", //
+                  "[Nr]", "Name", "Type", "Address", "Offset", "Size", "EntrySize", "Flags", "Link", "Info", "Align");
+
+        for(int i = 0; const auto x64 : elf.sectionHeaders()) {
+          out.print("  [{num:>2}] {name:<18} {type:<15} {address:>016x} {offset:>08x} {size:>016x} "
+                    "{entrySize:>016x} {flags:<5} {link:<4} {info:<4} {align}\n",
+                    "num"_a = i++, "name"_a = elf.sectionName(x64), "type"_a = feelelf::getSectionHeaderType(x64.type),
+                    "address"_a = x64.addr, "offset"_a = x64.offset, "size"_a = x64.size, "entrySize"_a = x64.entsize,
+                    "flags"_a = feelelf::getSectionHeaderFlag(x64.flags), "link"_a = x64.link, "info"_a = x64.info,
+                    "align"_a = x64.addralign);
         }
       }
 
-      fmt::print("\nKey to Flags:\n"
-                 "  W (write), A (alloc), X (execute), M (merge), S (strings), I (info),\n"
-                 "  L (link order), O (extra OS processing required), G (group), T (TLS),\n"
-                 "  C (compressed), x (unknown), o (OS specific), E (exclude),\n"
-                 "  p (processor specific)\n");
+      out.print("\nKey to Flags:\n"
+                "  W (write), A (alloc), X (execute), M (merge), S (strings), I (info),\n"
+                "  L (link order), O (extra OS processing required), G (group), T (TLS),\n"
+                "  C (compressed), x (unknown), o (OS specific), E (exclude),\n"
+                "  p (processor specific)\n");
     }
 
-    if(show_symbols) {
-      show_dynamic_symbols = true;
-
-      if(const auto &symbols = header.symbols(); !std::empty(symbols)) {
-        fmt::print("\nSymbol table '{}' contains {} entries:\n", ".symtab", std::size(symbols));
-        if(header.fileClass() == "ELF32") {
-
-          fmt::print("{num:>8} {value:^9} {size:>4} {type:^7} {bind:<5} {vis:^10} {index:>5} {name}\n",
-                     "num"_a = "Num:", "value"_a = "Value", "size"_a = "Size", "type"_a = "Type", "bind"_a = "Bind",
-                     "vis"_a = "Visibility", "index"_a = "Index", "name"_a = "Name");
-
-          for(int i = 0; const auto &sym : symbols) {
-            const auto &x86 = std::get<feelelf::Elf32_Symbol_t>(sym);
-            fmt::print("{num:>7}: {value:>08x} {size:>5} {type:<7} {binding:<6} {visibility:<9} {index:<5} {name}\n",
-                       "num"_a = i++, "value"_a = x86.value, "size"_a = x86.size,
-                       "type"_a = feelelf::getSymbolType(x86.info), "binding"_a = feelelf::getSymbolBind(x86.info),
-                       "visibility"_a = feelelf::getSymbolVisibility(x86.other),
-                       "index"_a = feelelf::getSymbolIndex(x86.shndx), "name"_a = header.getSymbolName(x86.name));
+    if(options.show_symbols) {
+      if(const auto symbols = elf.symbolTable(); !symbols.empty()) {
+        out.print("\nSymbol table '{}' contains {} entries:\n", ".symtab", symbols.size());
+        if constexpr(!Elf::is_64bit) {
+
+          out.print("{num:>8} {value:^9} {size:>4} {type:^7} {bind:<5} {vis:^10} {index:>5} {name}\n",
+                    "num"_a = "Num:", "value"_a = "Value", "size"_a = "Size", "type"_a = "Type", "bind"_a = "Bind",
+                    "vis"_a = "Visibility", "index"_a = "Index", "name"_a = "Name");
+
+          for(int i = 0; const auto x86 : symbols) {
+            out.print("{num:>7}: {value:>08x} {size:>5} {type:<7} {binding:<6} {visibility:<9} {index:<5} {name}\n",
+                      "num"_a = i++, "value"_a = x86.value, "size"_a = x86.size,
+                      "type"_a = feelelf::getSymbolType(x86.info), "binding"_a = feelelf::getSymbolBind(x86.info),
+                      "visibility"_a = feelelf::getSymbolVisibility(x86.other),
+                      "index"_a = feelelf::getSymbolIndex(x86.shndx), "name"_a = elf.symbolName(x86));
           }
         }
 
         else {
-          fmt::print("{num:>8} {value:^17} {size:>4} {type:^6} {bind:^6} {vis:<8} {index:>5} {name}\n",
-                     "num"_a = "Num:", "value"_a = "Value", "size"_a = "Size", "type"_a = "Type", "bind"_a = "Bind",
-                     "vis"_a = "Visibility", "index"_a = "Index", "name"_a = "Name");
-
-          for(int i = 0; const auto &sym : symbols) {
-            const auto &x64 = std::get<feelelf::Elf64_Symbol_t>(sym);
-            fmt::print("{num:>7}: {value:>016x} {size:>5} {type:<7} {binding:<6} {visibility:<9} {index:<5} {name}\n",
-                       "num"_a = i++, "value"_a = x64.value, "size"_a = x64.size,
-                       "type"_a = feelelf::getSymbolType(x64.info), "binding"_a = feelelf::getSymbolBind(x64.info),
-                       "visibility"_a = feelelf::getSymbolVisibility(x64.other),
-                       "index"_a = feelelf::getSymbolIndex(x64.shndx), "name"_a = header.getSymbolName(x64.name));
+          out.print("{num:>8} {value:^17} {size:>4} {type:^6} {bind:^6} {vis:<8} {index:>5} {name}\n",
+                    "num"_a = "Num:", "value"_a = "Value", "size"_a = "Size", "type"_a = "Type", "bind"_a = "Bind",
+                    "vis"_a = "Visibility", "index"_a = "Index", "name"_a = "Name");
+
+          for(int i = 0; const auto x64 : symbols) {
+            out.print("{num:>7}: {value:>016x} {size:>5} {type:<7} {binding:<6} {visibility:<9} {index:<5} {name}\n",
+                      "num"_a = i++, "value"_a = x64.value, "size"_a = x64.size,
+                      "type"_a = feelelf::getSymbolType(x64.info), "binding"_a = feelelf::getSymbolBind(x64.info),
+                      "visibility"_a = feelelf::getSymbolVisibility(x64.other),
+                      "index"_a = feelelf::getSymbolIndex(x64.shndx), "name"_a = elf.symbolName(x64));
           }
         }
       }
     }
 
-    if(show_dynamic_symbols) {
-      if(const auto &dynSymbols = header.dynamicSymbols(); !std::empty(dynSymbols)) {
-        fmt::print("\nSymbol table '{}' contains {} entries:\n", ".dynsym", std::size(dynSymbols));
+    if(options.show_dynamic_symbols) {
+      if(const auto dynSymbols = elf.dynamicSymbolTable(); !dynSymbols.empty()) {
+        out.print("\nSymbol table '{}' contains {} entries:\n", ".dynsym", dynSymbols.size());
 
-        if(header.fileClass() == "ELF32") {
+        if constexpr(!Elf::is_64bit) {
 
-          fmt::print("{num:>8} {value:^8} {size:>5} {type:^6} {bind:^6} {vis:<8} {index:>5} {name}\n",
-                     "num"_a = "Num:", "value"_a = "Value", "size"_a = "Size", "type"_a = "Type", "bind"_a = "Bind",
-                     "vis"_a = "Visibility", "index"_a = "Index", "name"_a = "Name");
+          out.print("{num:>8} {value:^8} {size:>5} {type:^6} {bind:^6} {vis:<8} {index:>5} {name}\n",
+                    "num"_a = "Num:", "value"_a = "Value", "size"_a = "Size", "type"_a = "Type", "bind"_a = "Bind",
+                    "vis"_a = "Visibility", "index"_a = "Index", "name"_a = "Name");
 
-          for(int i = 0; const auto &sym : dynSymbols) {
-            const auto &x86 = std::get<feelelf::Elf32_Symbol_t>(sym);
-            fmt::print("{num:>7}: {value:>08x} {size:>5} {type:<7} {binding:<6} {visibility:<9} {index:<5} {name:}\n",
-                       "num"_a = i++, "value"_a = x86.value, "size"_a = x86.size,
-                       "type"_a = feelelf::getSymbolType(x86.info), "binding"_a = feelelf::getSymbolBind(x86.info),
-                       "visibility"_a = feelelf::getSymbolVisibility(x86.other), "index"_a = x86.shndx,
-                       "name"_a = header.getDynamicSymbolName(x86.name));
+          for(int i = 0; const auto x86 : dynSymbols) {
+            out.print("{num:>7}: {value:>08x} {size:>5} {type:<7} {binding:<6} {visibility:<9} {index:<5} {name:}\n",
+                      "num"_a = i++, "value"_a = x86.value, "size"_a = x86.size,
+                      "type"_a = feelelf::getSymbolType(x86.info), "binding"_a = feelelf::getSymbolBind(x86.info),
+                      "visibility"_a = feelelf::getSymbolVisibility(x86.other), "index"_a = x86.shndx,
+                      "name"_a = elf.dynamicSymbolName(x86));
           }
         }
 
         else {
-          fmt::print("{num:>8} {value:^17} {size:>4} {type:^6} {bind:^6} {vis:<8} {index:>5} {name}\n",
-                     "num"_a = "Num:", "value"_a = "Value", "size"_a = "Size", "type"_a = "Type", "bind"_a = "Bind",
-                     "vis"_a = "Visibility", "index"_a = "Index", "name"_a = "Name");
-
-          for(int i = 0; const auto &sym : dynSymbols) {
-            const auto &x64 = std::get<feelelf::Elf64_Symbol_t>(sym);
-            fmt::print("{num:>7}: {value:>016x} {size:>5} {type:<7} {binding:<6} {visibility:<9} {index:<5} {name}\n",
-                       "num"_a = i++, "value"_a = x64.value, "size"_a = x64.size,
-                       "type"_a = feelelf::getSymbolType(x64.info), "binding"_a = feelelf::getSymbolBind(x64.info),
-                       "visibility"_a = feelelf::getSymbolVisibility(x64.other), "index"_a = x64.shndx,
-                       "name"_a = header.getDynamicSymbolName(x64.name));
+          out.print("{num:>8} {value:^17} {size:>4} {type:^6} {bind:^6} {vis:<8} {index:>5} {name}\n",
+                    "num"_a = "Num:", "value"_a = "Value", "size"_a = "Size", "type"_a = "Type", "bind"_a = "Bind",
+                    "vis"_a = "Visibility", "index"_a = "Index", "name"_a = "Name");
+
+          for(int i = 0; const auto x64 : dynSymbols) {
+            out.print("{num:>7}: {value:>016x} {size:>5} {type:<7} {binding:<6} {visibility:<9} {index:<5} {name}\n",
+                      "num"_a = i++, "value"_a = x64.value, "size"_a = x64.size,
+                      "type"_a = feelelf::getSymbolType(x64.info), "binding"_a = feelelf::getSymbolBind(x64.info),
+                      "visibility"_a = feelelf::getSymbolVisibility(x64.other), "index"_a = x64.shndx,
+                      "name"_a = elf.dynamicSymbolName(x64));
           }
         }
       }
     }
-
-    if(show_notes) {
-      for(const auto &[noteSectionName, noteTuple] : header.notes()) {
-        const auto &[noteName, noteDescSize, noteType] = noteTuple;
-        fmt::print("Displaying notes found in: {}\n", noteSectionName);
-        fmt::print("  Owner                Data size 	Description\n");
-        fmt::print("  {}                  {:#x}       {}\n", noteName, noteDescSize, noteType);
+  });
+
+  if(options.show_notes) {
+    for(const auto &notes : header.notes()) {
+      if(notes.name().empty())
+        out.print("\nDisplaying notes found at file offset {:#010x} with length {:#010x}:\n", notes.offset(),
+                  notes.size());
+      else out.print("\nDisplaying notes found in: {}\n", notes.name());
+      out.print("  Owner                Data size \tDescription\n");
+
+      for(const auto &note : notes) {
+        const auto type = feelelf::getNoteType(note.name, note.type);
+        out.print("  {:<20} {:#010x}\t", note.name, note.desc.size());
+        if(type == "Unknown") out.print("Unknown note type: ({:#010x})\n", note.type);
+        else out.print("{}\n", type);
+
+        if(note.name != "GNU") continue;
+        if(note.type == 3) out.print("    Build ID: {:02x}\n", fmt::join(note.desc, ""));
+        if(note.type == 1) {
+          constexpr std::array<std::string_view, 4> os{"Linux", "GNU", "Solaris2", "FreeBSD"};
+          const auto id = note.word(0);
+          out.print("    OS: {}, ABI: {}.{}.{}\n", id < os.size() ? os[id] : "Unknown", note.word(1), note.word(2),
+                    note.word(3));
+        }
       }
     }
+  }
 
-    if(show_relocations) {
-      const auto &relocations = header.relocations();
-      if(std::empty(relocations)) {
-        fmt::print("\nThere are no relocations in this file.\n");
-        continue;
+  if(options.show_dynamic) {
+    const auto entries = header.dynamic();
+    if(std::empty(entries)) {
+      out.print("\nThere is no dynamic section in this file.\n");
+    } else {
+      // .dynamic, or the PT_DYNAMIC segment when there are no section headers
+      std::size_t offset = 0;
+      if(const auto *section = header.findSection(".dynamic"))
+        offset = std::visit([](const auto &sh) -> std::size_t { return sh.offset; }, section->header);
+      else
+        for(const auto &ph : header.programHeaders())
+          std::visit([&offset](const auto &x) { if(x.type == 2) offset = x.offset; }, ph);
+      const int tag_width = header.fileClass() == "ELF32" ? 8 : 16;
+
+      // tags whose value is a size in bytes, and tags whose value is a number of entries
+      constexpr std::array<std::int64_t, 12> size_tags{2, 8, 9, 10, 11, 18, 19, 27, 28, 33, 35, 37};
+      constexpr std::array<std::int64_t, 4> count_tags{0x6ffffff9, 0x6ffffffa, 0x6ffffffd, 0x6fffffff};
+
+      out.print("\nDynamic section at offset {:#x} contains {} entries:\n", offset, entries.size());
+      out.print("  Tag        Type                         Name/Value\n");
+
+      for(const auto &[tag, value, name] : entries) {
+        const auto type = feelelf::getDynamicTag(tag);
+        const std::size_t type_width = 35 - tag_width; // the columns line up whatever the width of the tag
+        out.print(" 0x{:0{}x} ({}){:{}}", static_cast<std::uint64_t>(tag), tag_width, type, "",
+                  type.size() < type_width ? type_width - type.size() : 1);
+
+        switch(tag) {
+        case 1:  out.print("Shared library: [{}]\n", name); break;
+        case 14: out.print("Library soname: [{}]\n", name); break;
+        case 15: out.print("Library rpath: [{}]\n", name); break;
+        case 29: out.print("Library runpath: [{}]\n", name); break;
+        case 20: out.print("{}\n", value == 7 ? "RELA" : "REL"); break;
+        default:
+          if(std::ranges::find(size_tags, tag) != size_tags.end()) out.print("{} (bytes)\n", value);
+          else if(std::ranges::find(count_tags, tag) != count_tags.end()) out.print("{}\n", value);
+          else out.print("{:#x}\n", value);
+        }
       }
+    }
+  }
 
-      if(header.fileClass() == "ELF32") {
-        for(const auto &[section, entries] : relocations) {
-          fmt::print("\nRelocation section '{name:}' at offset {offset:#x} contains {nEntry:} entries:\n",
-                     "name"_a = section.first, "offset"_a = section.second, "nEntry"_a = entries.size());
+  if(options.show_relocations) {
+    const auto relocations = header.relocationTables();
+    const auto relative_relocations = header.relativeRelocationTables();
+    if(std::empty(relocations) && std::empty(relative_relocations)) {
+      out.print("\nThere are no relocations in this file.\n");
+      return;
+    }
 
-          fmt::print(" Offset     Info    Type            Sym.Value  Sym. Name\n");
+    // " + 1c", " - 4", or just the addend when there is no symbol
+    const auto print_addend = [&out](const feelelf::Relocation_t &rel) {
+      const auto magnitude = rel.addend < 0 ? 0 - static_cast<std::uint64_t>(rel.addend) : rel.addend;
+      if(rel.symbol == 0) out.print("{:x}", rel.addend);
+      else out.print(" {} {:x}", rel.addend < 0 ? '-' : '+', magnitude);
+    };
+
+    // By number when the machine's type names are unknown
+    const auto print_type = [&out](const feelelf::Relocation_t &rel, const std::size_t type) {
+      if(rel.type == "Unknown") out.print("{:<#17x} ", type);
+      else out.print("{:<17} ", rel.type);
+    };
+
+    if(header.fileClass() == "ELF32") {
+      for(const auto &section : relocations) {
+        out.print("\nRelocation section '{name:}' at offset {offset:#x} contains {nEntry:} entries:\n",
+                  "name"_a = section.name(), "offset"_a = section.offset(), "nEntry"_a = section.size());
+
+        out.print(" Offset     Info    Type            Sym.Value  Sym. Name{}\n",
+                  section.hasAddend() ? " + Addend" : "");
+
+        for(const auto rel : section) {
+          out.print("{:>08x} {:>08x} ", rel.offset, rel.info);
+          print_type(rel, feelelf::Elf32::relocationType(rel.info));
+          if(rel.symbol != 0) out.print("{:>08x}   {}", rel.symbol_value, rel.symbol_name);
+          else if(section.hasAddend()) out.print("{:11}", "");
+          if(section.hasAddend()) print_addend(rel);
+          out.print("\n");
+        }
+      }
+    }
 
-          for(const auto &[offset, info, type, symbolValue, symbolName] : entries)
-            fmt::print("{offset:>08x} {info:>08x} {type:<18} {symbolValue:>08x} {symbolName:}\n", "offset"_a = offset,
-                       "info"_a = info, "type"_a = type, "symbolValue"_a = symbolValue, "symbolName"_a = symbolName);
+    else {
+      for(const auto &section : relocations) {
+        out.print("\nRelocation section '{name:}' at offset {offset:#x} contains {nEntry:} entries:\n",
+                  "name"_a = section.name(), "offset"_a = section.offset(), "nEntry"_a = section.size());
+
+        out.print("  Offset          Info           Type           Sym. Value    Sym. Name{}\n",
+                  section.hasAddend() ? " + Addend" : "");
+
+        for(const auto rel : section) {
+          out.print("{:>012x}  {:>012x} ", rel.offset, rel.info);
+          print_type(rel, feelelf::Elf64::relocationType(rel.info));
+          if(rel.symbol != 0) out.print("{:>016x} {}", rel.symbol_value, rel.symbol_name);
+          else if(section.hasAddend()) out.print("{:19}", "");
+          if(section.hasAddend()) print_addend(rel);
+          out.print("\n");
         }
       }
+    }
 
-      else {
-        for(const auto &[section, entries] : relocations) {
-          fmt::print("\nRelocation section '{name:}' at offset {offset:#x} contains {nEntry:} entries:\n",
-                     "name"_a = section.first, "offset"_a = section.second, "nEntry"_a = entries.size());
+    const int address_width = header.fileClass() == "ELF32" ? 8 : 16;
+    for(const auto &section : relative_relocations) {
+      out.print("\nRelocation section '{name:}' at offset {offset:#x} contains {nEntry:} entries:\n",
+                "name"_a = section.name(), "offset"_a = section.offset(), "nEntry"_a = section.words());
+      out.print("  {} offsets\n", section.size());
 
-          fmt::print("  Offset          Info           Type           Sym. Value     Sym. Name\n");
+      for(const auto offset : section) {
+        out.print("{:0{}x}\n", offset, address_width);
+      }
+    }
+  }
+}
 
-          for(const auto &[offset, info, type, symbolValue, symbolName] : entries)
-            fmt::print("{offset:>012x}  {info:>012x} {type:<18} {symbolValue:>016x} {symbolName:}\n",
-                       "offset"_a = offset, "info"_a = info, "type"_a = type, "symbolValue"_a = symbolValue,
-                       "symbolName"_a = symbolName);
-        }
+// Cached reports are told apart by what they show and how. A report naming its file, in JSON records, triage lines or
+// the "File: " line, has the path in its tag too, so a file reached by another path or hard link isn't given a report
+// naming the old one. report_version is bumped whenever report() changes what it writes, so older reports are missed
+constexpr std::uint64_t report_version = 4;
+
+auto cacheTag(const Options &options, const fs::path &p) -> std::uint64_t {
+  std::uint64_t tag = report_version;
+  for(const bool shown : {options.show_fileheader, options.show_segments, options.show_sections, options.show_symbols,
+                          options.show_dynamic_symbols, options.show_notes, options.show_dynamic,
+                          options.show_relocations, options.triage, options.show_file_names})
+    tag = tag << 1 | static_cast<std::uint64_t>(shown);
+  tag = tag << 2 | static_cast<std::uint64_t>(options.output);
+
+  const bool named = options.output != Options::Output::text || options.triage || options.show_file_names;
+  if(named) tag ^= std::hash<std::string>{}(p.string()) << 16;
+  return tag;
+}
+
+struct ReportCache {
+  feelelf::MetadataCache records;
+  std::mutex mutex; // for put(), lookups need no lock
+};
+
+// A file unchanged since its report was cached is answered from the cache without being opened. Otherwise it is
+// reported as usual, and the report cached. Members of archives aren't cached, the cache knows whole files only
+void reportCached(const Target &target, const Options &options, Writer &out, ReportCache &cache) {
+  const auto key = target.archive ? std::nullopt : feelelf::fileKey(target.path.string().c_str());
+  if(!key) {
+    report(target, options, out);
+    return;
+  }
+
+  const auto tag = cacheTag(options, target.path);
+  if(const auto cached = cache.records.find(*key, tag)) {
+    out.write(*cached);
+    return;
+  }
+
+  Writer fresh; // held whole, to be cached
+  report(target, options, fresh);
+  out.write(fresh.view());
+
+  std::lock_guard lock{cache.mutex};
+  cache.records.put(*key, tag, fresh.view());
+}
+
+// Archives are told by their first bytes, and mapped whole only then
+auto openArchive(const fs::path &p) -> std::shared_ptr<const feelelf::Archive> {
+  std::array<feelelf::Elf_byte, feelelf::Archive::magic_size> start{};
+  if(!readStart(p, start) || !feelelf::isArchive(start)) return nullptr;
+
+  auto archive = std::make_shared<feelelf::Archive>();
+  if(!archive->open(p.string().c_str())) return nullptr;
+  return archive;
+}
+
+using NextTarget = std::function<std::optional<Target>()>;
+using ReportTarget = std::function<void(std::size_t, const Target &, Writer &)>;
+
+// Reports every target next() gives until it gives none, on jobs threads, and writes the reports out in the order of
+// the targets. Each target is taken as soon as it is given, while whatever gives them goes on looking for more, and a
+// handful of reports per thread are held at most, so memory use doesn't grow with the number of targets. Returns the
+// number of targets reported
+auto reportAll(const NextTarget &next, const unsigned jobs, const ReportTarget &report_target) -> std::size_t {
+  std::size_t count = 0;
+
+  if(jobs == 1) {
+    Writer out{stdout};
+    while(const auto target = next()) {
+      report_target(count++, *target, out);
+      out.writeTo(stdout);
+    }
+    return count;
+  }
+
+  struct Pending {
+    Writer out;
+    bool done = false;
+  };
+  std::deque<Pending> pending; // reports not written yet, in the order of the files
+  std::mutex done_mutex;
+  std::condition_variable done_cv;
+
+  // Writes out the reports at the front that are done, waiting for them until no more than keep are left
+  const auto writeOut = [&](const std::size_t keep) {
+    while(!pending.empty()) {
+      {
+        std::unique_lock lock{done_mutex};
+        if(pending.size() > keep) done_cv.wait(lock, [&] { return pending.front().done; });
+        else if(!pending.front().done) return;
       }
+      pending.front().out.writeTo(stdout);
+      pending.pop_front();
     }
+  };
+
+  const std::size_t held = 8 * std::size_t{jobs};
+  ThreadPool pool{jobs};
+  while(auto target = next()) {
+    writeOut(held - 1);
+
+    auto &report = pending.emplace_back(); // deque elements stay put as others are added and removed
+    pool.submit([&, i = count++, target = std::move(*target)] {
+      report_target(i, target, report.out);
+      {
+        std::lock_guard lock{done_mutex};
+        report.done = true;
+      }
+      done_cv.notify_one();
+    });
+  }
+
+  writeOut(0);
+  return count;
+}
+
+}
+
+int main(int argc, const char *argv[]) {
+  std::vector<fs::path> elf_files;
+  std::vector<fs::path> modules;
+
+  Options options;
+  bool show_headers = false;
+  bool recursive = false;
+  unsigned int jobs = 1;
+  std::string output = "text";
+  std::string cache_path;
+
+  CLI::App app{{}, "readelf"};
+  CLI::App *symbolize = nullptr;
+  try {
+    app.set_help_flag("-H, --help", "Display this information");
+    app.set_version_flag("-v,--version", "readelf version: 0.0.1", "Display version number of feelelf");
+
+    app.add_flag("-h,--file-header", options.show_fileheader, "Display the ELF file header");
+
+    app.add_flag("-l,--program-headers", options.show_segments, "Display the ELF file header");
+    app.add_flag("--segments", options.show_segments, "An alias for --program-headers");
+
+    app.add_flag("-S,--section-headers", options.show_sections, "Display the sections' header");
+    app.add_flag("--sections", options.show_sections, "An alias for --section-headers");
+
+    app.add_flag("-s,--syms", options.show_symbols, "Display the symbol table");
+    app.add_flag("--symbols", options.show_symbols, "An alias for --syms");
+    app.add_flag("--dyn-syms", options.show_dynamic_symbols, "Display the dynamic symbol table");
+    app.add_flag("-n,--notes", options.show_notes, "Display the core notes (if present)");
+    app.add_flag("-d,--dynamic", options.show_dynamic, "Display the dynamic section (if present)");
+    app.add_flag("-r,--relocs", options.show_relocations, "Display the relocations (if present)");
+
+    app.add_flag("-e,--headers", show_headers, "Equivalent to: -h -l -s");
+
+    app.add_flag("--triage", options.triage, "Classify files by reading their headers only: class, type, machine, "
+                                             "OS/ABI, PIE and stripped");
+
+    app.add_flag("--recursive", recursive, "Look for ELF files in the directories given and all those below them, "
+                                           "following symbolic links");
+
+    app.add_option("-j,--jobs", jobs, "Decode files on N threads, 0 means one per hardware thread")
+        ->check(CLI::NonNegativeNumber);
+
+    app.add_option("--output", output, "Output format: text, json (one array of file objects) or ndjson (one record "
+                                       "per line)")
+        ->check(CLI::IsMember({"text", "json", "ndjson"}));
+
+    app.add_option("--cache", cache_path, "Answer files unchanged since the last run from reports cached in FILE, and "
+                                          "cache the reports of the others there");
+
+    app.add_option("elf-file(s)", elf_files)->option_text(" ... ");
+
+    symbolize = app.add_subcommand("symbolize", "Read hex addresses or module+offset pairs from stdin and print "
+                                                      "the symbols they fall in");
+    symbolize->add_option("elf-file(s)", modules, "Modules bare addresses are looked up in, the first one is used")
+        ->option_text(" ... ");
+
+    app.parse(argc, argv);
+  }
+  catch(CLI::ParseError &e) {
+    return app.exit(e);
+  }
+
+  if(*symbolize) {
+    Symbolizer{modules}.run(stdin, stdout);
+    return 0;
+  }
+
+  if(show_headers) {
+    options.show_fileheader = options.show_segments = options.show_sections = true;
   }
+
+  if(options.show_symbols) {
+    options.show_dynamic_symbols = true;
+  }
+
+  if(jobs == 0) jobs = std::max(std::thread::hardware_concurrency(), 1U);
+
+  if(output == "json") options.output = Options::Output::json;
+  else if(output == "ndjson") options.output = Options::Output::ndjson;
+
+  options.show_file_names = recursive || elf_files.size() > 1;
+
+  ReportCache cache;
+  if(!cache_path.empty()) cache.records.open(cache_path.c_str()); // a missing cache is an empty one
+
+  // Uncached, --triage probes the files given up front so their reads are submitted together
+  std::vector<std::optional<feelelf::Probe_t>> probes;
+  if(options.triage && cache_path.empty() && !recursive) {
+    std::vector<std::string> names;
+    names.reserve(elf_files.size());
+    for(const auto &p : elf_files) names.push_back(p.string());
+    probes = feelelf::probeAll(names);
+  }
+
+  // In json the reports of all the files make up one array
+  const bool json = options.output == Options::Output::json;
+  const auto report_target = [&](const std::size_t i, const Target &target, Writer &out) {
+    if(json) out.write(i == 0 ? "[" : ",\n");
+    if(!probes.empty() && !target.archive) reportTriage(target.name(), probes[target.file], options, out);
+    else if(cache_path.empty()) report(target, options, out);
+    else reportCached(target, options, out, cache);
+  };
+
+  // Files found in directories are decoded as the walk goes on. The queue between the two keeps the walk from getting
+  // far ahead
+  BoundedQueue<fs::path> found{1024};
+  std::jthread crawler;
+  std::function<std::optional<fs::path>()> next_file;
+  if(recursive) {
+    crawler = std::jthread{[&] { Crawler{found}.crawl(elf_files); }};
+    next_file = [&] { return found.pop(); };
+  }
+  else {
+    next_file = [&, i = std::size_t{0}]() mutable -> std::optional<fs::path> {
+      if(i == elf_files.size()) return std::nullopt;
+      return elf_files[i++];
+    };
+  }
+
+  // Every archive is replaced by its members, each one reported as if it were a file, so that with -j members are
+  // decoded in parallel. They are all viewed in place in the one mapping of the archive
+  std::size_t files = 0;
+  Target archive_members;
+  feelelf::Archive::iterator member;
+  const NextTarget next = [&]() -> std::optional<Target> {
+    for(;;) {
+      if(archive_members.archive) {
+        if(member != std::default_sentinel) {
+          archive_members.member = *member;
+          ++member;
+          return archive_members;
+        }
+        archive_members.archive.reset();
+      }
+
+      auto p = next_file();
+      if(!p) return std::nullopt;
+
+      const auto file = files++;
+      const bool elf = !probes.empty() && probes[file]; // probed already, not an archive
+      if(auto archive = elf ? nullptr : openArchive(*p)) {
+        archive_members = {std::move(*p), file, std::move(archive)};
+        member = archive_members.archive->begin();
+        continue;
+      }
+      return Target{std::move(*p), file};
+    }
+  };
+
+  const auto count = reportAll(next, jobs, report_target);
+
+  if(json) std::fputs(count == 0 ? "[]\n" : "]\n", stdout);
+  if(cache.records.modified() && !cache.records.save(cache_path.c_str()))
+    std::fprintf(stderr, "readelf: Warning: couldn't write the cache to '%s'\n", cache_path.c_str());
 }
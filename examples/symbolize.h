@@ -0,0 +1,191 @@
+#pragma once
+
+#include <feelelf/feelelf.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+// Pipe mode symbolizer: reads lines holding a hex address, or a module+offset pair, and writes each line back followed
+// by the symbol the address falls in, e.g. "libc.so.6+0x29d90 __libc_start_call_main+0x80". Addresses are link time
+// addresses, the ones the symbol tables hold. Bare addresses are looked up in the first module given, any other module
+// is opened the first time a line names it and kept open until the end.
+// Input is taken as it arrives, up to a large chunk at a time, and the addresses of the complete lines taken are
+// resolved in one batch per module. Their answers are written out and flushed before more input is waited for, so a
+// caller writing one line and waiting for its answer, as a coprocess does, gets it
+class Symbolizer {
+  struct Module {
+    feelelf::FileHeader file;
+    feelelf::SymbolIndex index;
+  };
+
+  struct NameHash {
+    using is_transparent = void;
+    auto operator()(std::string_view name) const noexcept -> std::size_t {
+      return std::hash<std::string_view>{}(name);
+    }
+  };
+
+  std::vector<std::unique_ptr<Module>> opened;
+  std::unordered_map<std::string, Module *, NameHash, std::equal_to<>> modules; // nullptr for files that aren't ELF
+  Module *default_module = nullptr;
+
+  // One input line
+  struct Query {
+    std::string_view line;
+    Module *module = nullptr;
+    std::size_t address = 0;
+    feelelf::Symbolized_t result{};
+  };
+
+  static constexpr std::size_t chunk_size = 1 << 20;
+
+  // Whatever input is available, blocking only while there is none. 0 at the end of the input or on errors
+  static auto readSome(std::FILE *in, std::span<char> buffer) noexcept -> std::size_t {
+#if defined(_WIN32)
+    const int n = ::_read(::_fileno(in), buffer.data(), static_cast<unsigned>(buffer.size()));
+    return n > 0 ? static_cast<std::size_t>(n) : 0;
+#else
+    for(;;) {
+      const auto n = ::read(::fileno(in), buffer.data(), buffer.size());
+      if(n >= 0) return static_cast<std::size_t>(n);
+      if(errno != EINTR) return 0;
+    }
+#endif
+  }
+
+  auto load(std::string_view name) -> Module * {
+    if(const auto it = modules.find(name); it != modules.end()) return it->second;
+
+    auto module = std::make_unique<Module>();
+    Module *loaded = nullptr;
+    if(module->file.open(std::string{name}.c_str())) {
+      module->file.decode();
+      module->index = feelelf::SymbolIndex{module->file};
+      loaded = opened.emplace_back(std::move(module)).get();
+    }
+    modules.emplace(name, loaded);
+    return loaded;
+  }
+
+  static auto parseHex(std::string_view text, std::size_t &value) noexcept -> bool {
+    if(text.starts_with("0x") || text.starts_with("0X")) text.remove_prefix(2);
+    if(text.empty()) return false;
+
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value, 16);
+    return error == std::errc{} && end == text.data() + text.size();
+  }
+
+  auto parse(std::string_view line) -> Query {
+    Query query{line};
+
+    auto text = line;
+    while(!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+      text.remove_prefix(1);
+    while(!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r'))
+      text.remove_suffix(1);
+
+    auto *module = default_module;
+    if(const auto plus = text.rfind('+'); plus != std::string_view::npos) {
+      module = load(text.substr(0, plus));
+      text.remove_prefix(plus + 1);
+    }
+
+    if(parseHex(text, query.address)) query.module = module;
+    return query;
+  }
+
+  // Resolves a chunk's queries module by module, so each module's index is searched with one batch call
+  void resolve(std::vector<Query> &queries) {
+    std::unordered_map<Module *, std::vector<std::size_t>> by_module; // query positions
+    for(std::size_t i = 0; i != queries.size(); ++i)
+      if(queries[i].module) by_module[queries[i].module].push_back(i);
+
+    std::vector<std::size_t> addresses;
+    std::vector<feelelf::Symbolized_t> results;
+    for(const auto &[module, positions] : by_module) {
+      addresses.clear();
+      for(const auto i : positions)
+        addresses.push_back(queries[i].address);
+
+      results.resize(addresses.size());
+      module->index.lookup(addresses, results);
+
+      for(std::size_t j = 0; j != positions.size(); ++j)
+        queries[positions[j]].result = results[j];
+    }
+  }
+
+public:
+  explicit Symbolizer(std::span<const std::filesystem::path> paths) {
+    for(const auto &path : paths) {
+      auto *module = load(path.string());
+      if(!default_module) default_module = module;
+      modules.try_emplace(path.filename().string(), module); // a module can be named by its file name alone
+    }
+  }
+
+  void run(std::FILE *in, std::FILE *out) {
+    std::vector<char> input(chunk_size);
+    std::size_t kept = 0; // bytes of an unfinished line carried over from the previous chunk
+
+    fmt::memory_buffer output;
+    std::vector<Query> queries;
+
+    for(bool eof = false; !eof;) {
+      const auto n = readSome(in, std::span{input}.subspan(kept));
+      eof = n == 0;
+
+      std::string_view text{input.data(), kept + n};
+      queries.clear();
+      while(!text.empty()) {
+        const auto newline = text.find('\n');
+        if(newline == std::string_view::npos && !eof) break; // the rest of the line comes with the next chunk
+
+        const auto line = text.substr(0, newline);
+        if(!line.empty()) queries.push_back(parse(line));
+        text.remove_prefix(newline == std::string_view::npos ? text.size() : newline + 1);
+      }
+
+      resolve(queries);
+
+      for(const auto &query : queries) {
+        if(query.result.name.empty()) fmt::format_to(std::back_inserter(output), "{} ??\n", query.line);
+        else
+          fmt::format_to(std::back_inserter(output), "{} {}+{:#x}\n", query.line, query.result.name,
+                         query.result.offset);
+      }
+
+      if(output.size() != 0) {
+        std::fwrite(output.data(), 1, output.size(), out);
+        std::fflush(out);
+        output.clear();
+      }
+
+      // Carry an unfinished line over, a line longer than a whole chunk is dropped
+      kept = text.size() < input.size() ? text.size() : 0;
+      std::copy(text.begin(), text.begin() + static_cast<std::ptrdiff_t>(kept), input.begin());
+    }
+  }
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed size work-stealing pool. Every worker owns a deque, takes work from its front and, when it runs dry, steals
+// from the front of the others' deques so a few large files don't leave the rest of the workers idle. Tasks are run
+// about in the order they are submitted, the order reports are written out in.
+class ThreadPool {
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::vector<std::jthread> workers;
+
+  std::atomic<std::size_t> queued{0}; // tasks submitted but not yet taken by a worker
+  std::size_t next = 0;               // queue the next submitted task goes to
+
+  std::mutex sleep_mutex;
+  std::condition_variable wake;
+  bool stopping = false;
+
+public:
+  explicit ThreadPool(const std::size_t n_workers) {
+    for(std::size_t i = 0; i != n_workers; ++i)
+      queues.push_back(std::make_unique<Queue>());
+
+    for(std::size_t i = 0; i != n_workers; ++i)
+      workers.emplace_back([this, i] { run(i); });
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  auto operator=(const ThreadPool &) -> ThreadPool & = delete;
+
+  // Runs the tasks left in the queues, then joins the workers
+  ~ThreadPool() {
+    {
+      std::lock_guard lock{sleep_mutex};
+      stopping = true;
+    }
+    wake.notify_all();
+    workers.clear();
+  }
+
+  void submit(std::function<void()> task) {
+    {
+      std::lock_guard lock{sleep_mutex};
+      ++queued;
+    }
+
+    auto &queue = *queues[next++ % queues.size()];
+    {
+      std::lock_guard lock{queue.mutex};
+      queue.tasks.push_back(std::move(task));
+    }
+    wake.notify_one();
+  }
+
+private:
+  auto pop(const std::size_t self, std::function<void()> &task) -> bool {
+    auto &queue = *queues[self];
+    std::lock_guard lock{queue.mutex};
+    if(queue.tasks.empty()) return false;
+
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    return true;
+  }
+
+  auto steal(const std::size_t self, std::function<void()> &task) -> bool {
+    for(std::size_t i = 1; i != queues.size(); ++i) {
+      auto &victim = *queues[(self + i) % queues.size()];
+      std::lock_guard lock{victim.mutex};
+      if(victim.tasks.empty()) continue;
+
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      return true;
+    }
+    return false;
+  }
+
+  void run(const std::size_t self) {
+    for(std::function<void()> task;;) {
+      if(pop(self, task) || steal(self, task)) {
+        --queued;
+        task();
+        continue;
+      }
+
+      std::unique_lock lock{sleep_mutex};
+      wake.wait(lock, [this] { return queued != 0 || stopping; });
+      if(stopping && queued == 0) return;
+    }
+  }
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <fmt/format.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <iterator>
+#include <string_view>
+#include <utility>
+
+// Formats output into memory and writes it out in large chunks, one fwrite per chunk rather than one per line. A writer
+// given a file writes each chunk out as soon as it fills up, so the report of a huge file doesn't pile up in memory.
+// Otherwise everything is kept until writeTo(), which lets reports produced on different threads be written in order
+class Writer {
+  static constexpr std::size_t chunk_size = 1 << 20;
+
+  fmt::memory_buffer buffer;
+  std::FILE *file = nullptr;
+
+  void spill() {
+    if(file && buffer.size() >= chunk_size) writeTo(file);
+  }
+
+public:
+  Writer() = default;
+  explicit Writer(std::FILE *file) : file{file} {}
+
+  template <typename... Args>
+  void print(fmt::format_string<Args...> format, Args &&...args) {
+    fmt::format_to(std::back_inserter(buffer), format, std::forward<Args>(args)...);
+    spill();
+  }
+
+  // Appends text as it is, without going through a format string
+  void write(std::string_view text) {
+    buffer.append(text.data(), text.data() + text.size());
+    spill();
+  }
+
+  // What has been formatted and not written out yet
+  [[nodiscard]] auto view() const noexcept -> std::string_view {
+    return {buffer.data(), buffer.size()};
+  }
+
+  void writeTo(std::FILE *out) {
+    std::fwrite(buffer.data(), 1, buffer.size(), out);
+    buffer.clear();
+  }
+};
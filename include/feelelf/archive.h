@@ -0,0 +1,98 @@
+#pragma once
+
+#include <feelelf/feelelf.h>
+
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <string_view>
+
+namespace feelelf {
+
+// One member of an archive, see Archive
+struct Archive_Member_t {
+  std::string_view name;              // long names resolved, a path relative to the archive's directory if thin
+  std::size_t offset;                 // of the member's header in the archive
+  std::size_t size;                   // of its contents
+  std::span<const Elf_byte> contents; // viewed in place in the archive, empty in thin archives
+};
+
+// Static library, an "!<arch>" archive of object files, of the GNU or the BSD flavour. The archive is mapped once and
+// its members are viewed in place, nothing is extracted: each one is opened with FileHeader::open(member.contents).
+// The symbol tables and the GNU long name table aren't members. Members of thin archives ("!<thin>") are files of
+// their own, the archive only names them.
+// Iterating stops at the first malformed member header. Const member functions are safe to call concurrently, so the
+// members can be decoded on several threads
+class Archive {
+  MappedFile file;
+  std::string_view long_names; // GNU "//" member, names of more than 15 characters separated by "/\n"
+  bool thin = false;
+
+  // Decodes the member whose header is at offset or, if that is a symbol table or the long name table, the first one
+  // after it. Offset of the header following the member, 0 at the end or if a header is malformed
+  [[nodiscard]] auto read(std::size_t offset, Archive_Member_t &member) const noexcept -> std::size_t;
+
+public:
+  class iterator {
+    const Archive *archive = nullptr;
+    std::size_t next = 0; // offset of the next member's header in the archive
+    Archive_Member_t member{};
+    bool at_end = false;
+
+    void advance() noexcept {
+      next = next == 0 ? 0 : archive->read(next, member);
+      at_end = next == 0;
+    }
+
+  public:
+    using iterator_concept = std::input_iterator_tag;
+    using value_type = Archive_Member_t;
+    using difference_type = std::ptrdiff_t;
+
+    iterator() noexcept = default;
+    explicit iterator(const Archive *archive) noexcept : archive{archive}, next{magic_size} {
+      advance();
+    }
+
+    auto operator*() const noexcept -> const Archive_Member_t & {
+      return member;
+    }
+
+    auto operator++() noexcept -> iterator & {
+      advance();
+      return *this;
+    }
+
+    void operator++(int) noexcept {
+      advance();
+    }
+
+    friend auto operator==(const iterator &it, std::default_sentinel_t) noexcept -> bool {
+      return it.at_end;
+    }
+  };
+
+  static constexpr std::size_t magic_size = 8; // "!<arch>\n" or "!<thin>\n"
+
+  // False if the file can't be read or isn't an archive
+  [[nodiscard]] auto open(const char *file) noexcept -> bool;
+
+  [[nodiscard]] auto isThin() const noexcept -> bool {
+    return thin;
+  }
+
+  [[nodiscard]] auto bytes() const noexcept -> std::span<const Elf_byte>; // whole archive
+
+  [[nodiscard]] auto begin() const noexcept -> iterator {
+    return iterator{this};
+  }
+
+  [[nodiscard]] auto end() const noexcept -> std::default_sentinel_t {
+    return std::default_sentinel;
+  }
+};
+
+// Whether bytes, the start of a file, are the magic of an archive, thin or not
+[[nodiscard]] auto isArchive(std::span<const Elf_byte> bytes) noexcept -> bool;
+
+} // namespace feelelf
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <feelelf/feelelf.h>
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace feelelf {
+
+// What the file system tells of a file. A file whose key hasn't changed is taken to have the same contents
+struct File_Key_t {
+  std::uint64_t device;
+  std::uint64_t inode;
+  std::uint64_t size;
+  std::int64_t mtime; // in nanoseconds since the epoch
+
+  friend auto operator<=>(const File_Key_t &, const File_Key_t &) noexcept = default;
+};
+
+// Key of the file at path, nullopt if it can't be stat'ed (or the platform has no device and inode numbers)
+[[nodiscard]] auto fileKey(const char *path) noexcept -> std::optional<File_Key_t>;
+
+// Persistent cache of records about files, each one keyed by a File_Key_t and a tag the caller picks to tell apart
+// what the record holds. The cache file is a header, a table of entries sorted by key and the records, it is mapped
+// and searched in place, so opening it costs nothing however many files it knows.
+// Records put() are kept in memory until save(), which writes them together with the old ones still valid to a new
+// file renamed over the old one, readers never see a half written cache. The cache is in the byte order of the
+// machine that wrote it, any other is taken as no cache at all
+class MetadataCache {
+  struct Key {
+    File_Key_t file;
+    std::uint64_t tag;
+
+    friend auto operator<=>(const Key &, const Key &) noexcept = default;
+  };
+
+  MappedFile file;
+  std::size_t count = 0; // entries in file
+  std::map<Key, std::string> added;
+
+public:
+  // False and an empty cache if there is no cache at path or it isn't one
+  auto open(const char *path) noexcept -> bool;
+
+  // The record of file under tag, nullopt if there is none. Only the cache as opened is searched, so lookups may run on
+  // several threads while one thread puts records
+  [[nodiscard]] auto find(const File_Key_t &key, std::uint64_t tag) const noexcept -> std::optional<std::string_view>;
+
+  void put(const File_Key_t &key, std::uint64_t tag, std::string_view record);
+
+  // Writes the cache to path, records of files whose size or mtime have changed since are dropped. False on I/O errors
+  auto save(const char *path) const -> bool;
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t { // records in the cache as opened
+    return count;
+  }
+
+  [[nodiscard]] auto modified() const noexcept -> bool { // whether anything was put since open
+    return !added.empty();
+  }
+};
+
+} // namespace feelelf
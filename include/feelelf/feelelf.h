@@ -1,11 +1,23 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <iterator>
 #include <map>
+#include <optional>
+#include <ranges>
 #include <span>
 #include <string_view>
 #include <string>
 #include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -203,15 +215,651 @@ struct Elf64_Rela_t {
   Elf64_SXword addend;
 };
 
+template <std::integral T>
+[[nodiscard]] constexpr auto byteswap(const T value) noexcept -> T {
+  auto bytes = std::bit_cast<std::array<Elf_byte, sizeof(T)>>(value);
+  std::ranges::reverse(bytes);
+  return std::bit_cast<T>(bytes);
+}
+
+// Read-only image of a whole file. mmap'ed where the platform allows it, otherwise read into memory once with pread
+class MappedFile {
+  const Elf_byte *base = nullptr;
+  std::size_t length = 0;
+  bool is_mapped = false; // false when base is a heap buffer filled by the fallback path
+
+public:
+  MappedFile() noexcept = default;
+  MappedFile(const MappedFile &) = delete;
+  MappedFile(MappedFile &&other) noexcept;
+  auto operator=(const MappedFile &) -> MappedFile & = delete;
+  auto operator=(MappedFile &&other) noexcept -> MappedFile &;
+  ~MappedFile();
+
+  [[nodiscard]] auto open(const char *file) noexcept -> bool;
+  void close() noexcept;
+
+  [[nodiscard]] auto bytes() const noexcept -> std::span<const Elf_byte>;
+};
+
+// Symbol name hashes of .gnu.hash and of the SysV .hash
+[[nodiscard]] constexpr auto gnuHash(std::string_view name) noexcept -> std::uint32_t {
+  std::uint32_t hash = 5381;
+  for(const unsigned char c : name)
+    hash = hash * 33 + c;
+  return hash;
+}
+
+[[nodiscard]] constexpr auto elfHash(std::string_view name) noexcept -> std::uint32_t {
+  std::uint32_t hash = 0;
+  for(const unsigned char c : name) {
+    hash = (hash << 4) + c;
+    hash ^= (hash >> 24) & 0xf0;
+  }
+  return hash & 0x0fffffff;
+}
+
+// Random-access range over a table of fixed size entries, read in place from the file image. Entries are entsize bytes
+// apart, which can be more than sizeof(T). Dereferencing copies one entry out, so unaligned tables are read safely.
+template <typename T>
+class TableView {
+  const Elf_byte *first = nullptr;
+  std::size_t count = 0;
+  std::size_t stride = sizeof(T);
+
+public:
+  class iterator {
+    const Elf_byte *position = nullptr;
+    std::size_t stride = sizeof(T);
+
+  public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::input_iterator_tag; // entries are returned by value
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+
+    iterator() noexcept = default;
+    iterator(const Elf_byte *position, const std::size_t stride) noexcept : position{position}, stride{stride} {}
+
+    auto operator*() const noexcept -> T {
+      T entry;
+      std::memcpy(&entry, position, sizeof(T));
+      return entry;
+    }
+
+    auto operator[](const difference_type n) const noexcept -> T {
+      return *(*this + n);
+    }
+
+    auto operator++() noexcept -> iterator & {
+      position += stride;
+      return *this;
+    }
+
+    auto operator--() noexcept -> iterator & {
+      position -= stride;
+      return *this;
+    }
+
+    auto operator++(int) noexcept -> iterator {
+      auto copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    auto operator--(int) noexcept -> iterator {
+      auto copy = *this;
+      --*this;
+      return copy;
+    }
+
+    auto operator+=(const difference_type n) noexcept -> iterator & {
+      position += n * static_cast<difference_type>(stride);
+      return *this;
+    }
+
+    auto operator-=(const difference_type n) noexcept -> iterator & {
+      position -= n * static_cast<difference_type>(stride);
+      return *this;
+    }
+
+    friend auto operator+(iterator it, const difference_type n) noexcept -> iterator {
+      return it += n;
+    }
+
+    friend auto operator+(const difference_type n, iterator it) noexcept -> iterator {
+      return it += n;
+    }
+
+    friend auto operator-(iterator it, const difference_type n) noexcept -> iterator {
+      return it -= n;
+    }
+
+    friend auto operator-(const iterator &lhs, const iterator &rhs) noexcept -> difference_type {
+      return (lhs.position - rhs.position) / static_cast<difference_type>(lhs.stride);
+    }
+
+    friend auto operator==(const iterator &lhs, const iterator &rhs) noexcept -> bool {
+      return lhs.position == rhs.position;
+    }
+
+    friend auto operator<=>(const iterator &lhs, const iterator &rhs) noexcept {
+      return lhs.position <=> rhs.position;
+    }
+  };
+
+  TableView() noexcept = default;
+  TableView(std::span<const Elf_byte> table, const std::size_t entsize) noexcept :
+      first{table.data()},
+      count{entsize < sizeof(T) ? 0 : table.size() / entsize}, // a table with entries smaller than T is malformed
+      stride{entsize} {}
+
+  [[nodiscard]] auto begin() const noexcept -> iterator {
+    return {first, stride};
+  }
+
+  [[nodiscard]] auto end() const noexcept -> iterator {
+    return {first + count * stride, stride};
+  }
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t {
+    return count;
+  }
+
+  [[nodiscard]] auto empty() const noexcept -> bool {
+    return count == 0;
+  }
+
+  [[nodiscard]] auto operator[](const std::size_t i) const noexcept -> T {
+    return begin()[static_cast<std::ptrdiff_t>(i)];
+  }
+};
+using Symbol_Table_t = std::variant<TableView<Elf32_Symbol_t>, TableView<Elf64_Symbol_t>>;
+
+struct Section_t {
+  std::string_view name; // points into .shstrtab
+  Section_Header_t header;
+};
+
+// A relocation joined with the symbol it refers to. Names point into the file image
+struct Relocation_t {
+  std::size_t offset;
+  std::size_t info;
+  std::string_view type;        // machine specific, e.g. R_X86_64_PC32
+  std::int64_t addend;          // 0 for SHT_REL
+  std::size_t symbol;           // index into the linked symbol table, 0 for none
+  std::size_t symbol_value;
+  std::string_view symbol_name; // section name for STT_SECTION symbols, empty for symbol 0
+};
+
+// A .dynamic entry. Names point into the file image
+struct Dynamic_t {
+  std::int64_t tag;
+  std::size_t value;     // d_val or d_ptr
+  std::string_view name; // for DT_NEEDED, DT_SONAME, DT_RPATH and DT_RUNPATH, empty otherwise
+};
+
+// A note, name and descriptor point into the file image
+struct Note_t {
+  std::string_view name; // owner, e.g. "GNU"
+  std::uint32_t type;    // meaning depends on the owner
+  std::span<const Elf_byte> desc;
+  bool foreign = false; // the file's byte order is not the host's
+
+  // Descriptor word i in the host's byte order, 0 past the end of the descriptor
+  [[nodiscard]] auto word(const std::size_t i) const noexcept -> std::uint32_t {
+    if(i >= desc.size() / sizeof(std::uint32_t)) return 0;
+
+    std::uint32_t value;
+    std::memcpy(&value, desc.data() + i * sizeof(value), sizeof(value));
+    return foreign ? byteswap(value) : value;
+  }
+};
+
+struct Relocation_Section_t {
+  std::string_view name;
+  std::size_t offset;
+  bool has_addend; // SHT_RELA
+  std::vector<Relocation_t> entries;
+};
+
+// Types of one ELF class, ElfFile is parameterized on these
+struct Elf32 {
+  using Header = Elf32_Header_t;
+  using Program_Header = Elf32_Program_Header_t;
+  using Section_Header = Elf32_Section_Header_t;
+  using Symbol = Elf32_Symbol_t;
+  using Dynamic = Elf32_Dynamic_t;
+  using Note_header = Elf32_Note_header_t;
+  using Rel = Elf32_Rel_t;
+  using Rela = Elf32_Rela_t;
+  using Addr = Elf32_Addr;
+  using Off = Elf32_Off;
+
+  // r_info, symbol index and relocation type
+  [[nodiscard]] static constexpr auto relocationSymbol(const std::size_t info) noexcept -> std::size_t {
+    return info >> 8;
+  }
+
+  [[nodiscard]] static constexpr auto relocationType(const std::size_t info) noexcept -> std::size_t {
+    return info & 0xff;
+  }
+};
+
+struct Elf64 {
+  using Header = Elf64_Header_t;
+  using Program_Header = Elf64_Program_Header_t;
+  using Section_Header = Elf64_Section_Header_t;
+  using Symbol = Elf64_Symbol_t;
+  using Dynamic = Elf64_Dynamic_t;
+  using Note_header = Elf64_Note_header_t;
+  using Rel = Elf64_Rel_t;
+  using Rela = Elf64_Rela_t;
+  using Addr = Elf64_Addr;
+  using Off = Elf64_Off;
+
+  [[nodiscard]] static constexpr auto relocationSymbol(const std::size_t info) noexcept -> std::size_t {
+    return info >> 32;
+  }
+
+  [[nodiscard]] static constexpr auto relocationType(const std::size_t info) noexcept -> std::size_t {
+    return info & 0xffffffff;
+  }
+};
+
+// Relocations of one SHT_REL or SHT_RELA section, decoded and joined with their symbol one entry at a time while
+// iterating, so walking a huge section needs no memory of its own. Obtained through FileHeader::relocationTables()
+class RelocationView {
+  using Decoder = Relocation_t (*)(const RelocationView &, std::size_t);
+
+  std::string_view section_name;
+  std::size_t section_offset = 0;
+  bool has_addend = false;
+
+  std::span<const Elf_byte> table;
+  std::size_t entsize = 0;
+  std::size_t count = 0;
+
+  std::span<const Elf_byte> symbols; // linked symbol table, names come from its own linked string table
+  std::size_t symbol_entsize = 0;
+  std::string_view strings;
+  std::span<const Section_t> sections; // names of STT_SECTION symbols
+
+  std::string_view (*type_name)(unsigned int) = nullptr;
+  Decoder decoder = nullptr; // picked once per section for the file's class and REL or RELA
+
+  friend class FileHeader;
+
+  template <typename Class, typename Entry>
+  static auto decode(const RelocationView &view, const std::size_t index) noexcept -> Relocation_t {
+    const auto rel = TableView<Entry>{view.table, view.entsize}[index];
+
+    Relocation_t relocation{.offset = rel.offset,
+                            .info = rel.info,
+                            .type = view.type_name(static_cast<unsigned int>(Class::relocationType(rel.info))),
+                            .addend = 0,
+                            .symbol = Class::relocationSymbol(rel.info),
+                            .symbol_value = 0,
+                            .symbol_name = {}};
+
+    if constexpr(requires { rel.addend; }) relocation.addend = rel.addend;
+
+    const TableView<typename Class::Symbol> symbol_table{view.symbols, view.symbol_entsize};
+    if(relocation.symbol == 0 || relocation.symbol >= symbol_table.size()) return relocation;
+
+    const auto symbol = symbol_table[relocation.symbol];
+    relocation.symbol_value = symbol.value;
+
+    if((symbol.info & 0xf) == 3) { // STT_SECTION symbols are named after their section
+      if(symbol.shndx < view.sections.size()) relocation.symbol_name = view.sections[symbol.shndx].name;
+    } else if(symbol.name < view.strings.size()) {
+      const auto name = view.strings.substr(symbol.name);
+      relocation.symbol_name = name.substr(0, name.find('\0'));
+    }
+    return relocation;
+  }
+
+public:
+  class iterator {
+    const RelocationView *view = nullptr;
+    std::size_t index = 0;
+
+  public:
+    using iterator_concept = std::forward_iterator_tag;
+    using iterator_category = std::input_iterator_tag; // entries are returned by value
+    using value_type = Relocation_t;
+    using difference_type = std::ptrdiff_t;
+
+    iterator() noexcept = default;
+    iterator(const RelocationView *view, const std::size_t index) noexcept : view{view}, index{index} {}
+
+    auto operator*() const noexcept -> Relocation_t {
+      return view->decoder(*view, index);
+    }
+
+    auto operator++() noexcept -> iterator & {
+      ++index;
+      return *this;
+    }
+
+    auto operator++(int) noexcept -> iterator {
+      auto copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    friend auto operator==(const iterator &lhs, const iterator &rhs) noexcept -> bool {
+      return lhs.index == rhs.index;
+    }
+  };
+
+  [[nodiscard]] auto name() const noexcept -> std::string_view {
+    return section_name;
+  }
+
+  [[nodiscard]] auto offset() const noexcept -> std::size_t {
+    return section_offset;
+  }
+
+  [[nodiscard]] auto hasAddend() const noexcept -> bool {
+    return has_addend;
+  }
+
+  [[nodiscard]] auto begin() const noexcept -> iterator {
+    return {this, 0};
+  }
+
+  [[nodiscard]] auto end() const noexcept -> iterator {
+    return {this, count};
+  }
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t {
+    return count;
+  }
+
+  [[nodiscard]] auto empty() const noexcept -> bool {
+    return count == 0;
+  }
+};
+
+// Offsets relocated by one SHT_RELR section. The section packs relative relocations into words: an even word is an
+// address to relocate, an odd word is a bitmap whose bits 1 to 63 (31 for ELF32) mark which of the words following
+// the last address are relocated too. Bitmaps are expanded while iterating, a set bit at a time.
+// Obtained through FileHeader::relativeRelocationTables()
+class RelrView {
+  std::string_view section_name;
+  std::size_t section_offset = 0;
+
+  std::span<const Elf_byte> table;
+  std::size_t word_size = sizeof(Elf64_Addr);
+
+  friend class FileHeader;
+
+  [[nodiscard]] auto word(const std::size_t index) const noexcept -> std::uint64_t {
+    if(word_size == sizeof(Elf32_Addr)) {
+      Elf32_Addr value;
+      std::memcpy(&value, table.data() + index * word_size, sizeof(value));
+      return value;
+    }
+
+    Elf64_Addr value;
+    std::memcpy(&value, table.data() + index * word_size, sizeof(value));
+    return value;
+  }
+
+public:
+  class iterator {
+    const RelrView *view = nullptr;
+    std::size_t next = 0;          // next word to read
+    std::uint64_t bitmap = 0;      // bits of the current bitmap not visited yet, bit i stands for bitmap_base + i words
+    std::size_t bitmap_base = 0;
+    std::size_t base = 0;          // where the next bitmap starts
+    std::size_t where = 0;
+    bool at_end = false;
+
+    void advance() noexcept {
+      while(bitmap == 0) {
+        if(next == view->words()) {
+          at_end = true;
+          return;
+        }
+
+        const auto word = view->word(next++);
+        if((word & 1) == 0) {
+          where = word;
+          base = word + view->word_size;
+          return;
+        }
+
+        bitmap = word >> 1;
+        bitmap_base = base;
+        base += (view->word_size * 8 - 1) * view->word_size;
+      }
+
+      where = bitmap_base + static_cast<std::size_t>(std::countr_zero(bitmap)) * view->word_size;
+      bitmap &= bitmap - 1;
+    }
+
+  public:
+    using iterator_concept = std::input_iterator_tag;
+    using value_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    iterator() noexcept = default;
+    explicit iterator(const RelrView *view) noexcept : view{view} {
+      advance();
+    }
+
+    auto operator*() const noexcept -> std::size_t {
+      return where;
+    }
+
+    auto operator++() noexcept -> iterator & {
+      advance();
+      return *this;
+    }
+
+    void operator++(int) noexcept {
+      advance();
+    }
+
+    friend auto operator==(const iterator &it, std::default_sentinel_t) noexcept -> bool {
+      return it.at_end;
+    }
+  };
+
+  [[nodiscard]] auto name() const noexcept -> std::string_view {
+    return section_name;
+  }
+
+  [[nodiscard]] auto offset() const noexcept -> std::size_t {
+    return section_offset;
+  }
+
+  [[nodiscard]] auto begin() const noexcept -> iterator {
+    return iterator{this};
+  }
+
+  [[nodiscard]] auto end() const noexcept -> std::default_sentinel_t {
+    return std::default_sentinel;
+  }
+
+  // Address and bitmap words of the section
+  [[nodiscard]] auto words() const noexcept -> std::size_t {
+    return table.size() / word_size;
+  }
+
+  // Number of offsets, counted without expanding them
+  [[nodiscard]] auto size() const noexcept -> std::size_t {
+    std::size_t count = 0;
+    for(std::size_t i = 0; i != words(); ++i) {
+      const auto word = this->word(i);
+      count += (word & 1) == 0 ? 1 : static_cast<std::size_t>(std::popcount(word >> 1));
+    }
+    return count;
+  }
+
+  [[nodiscard]] auto empty() const noexcept -> bool {
+    return words() == 0;
+  }
+};
+
+// Notes of one SHT_NOTE section or PT_NOTE segment, read in place while iterating. Descriptors and the next note start
+// at offsets aligned to 4 bytes, or to 8 in sections and segments aligned to 8 as the ones of NT_GNU_PROPERTY_TYPE_0
+// notes are. Iteration stops at a note running past the end. Obtained through FileHeader::notes()
+class NoteView {
+  std::string_view section_name; // empty for a segment
+  std::size_t section_offset = 0;
+
+  std::span<const Elf_byte> notes;
+  std::size_t alignment = 4;
+  bool foreign = false;
+
+  friend class FileHeader;
+
+public:
+  class iterator {
+    const NoteView *view = nullptr;
+    std::size_t next = 0; // offset of the next note in the view
+    Note_t note{};
+    bool at_end = false;
+
+    // Offsets from the start of the notes, which is aligned, are rounded up
+    [[nodiscard]] auto padded(const std::size_t offset) const noexcept -> std::size_t {
+      return (offset + view->alignment - 1) & ~(view->alignment - 1);
+    }
+
+    void advance() noexcept {
+      const auto notes = view->notes;
+      if(notes.size() - next < sizeof(Elf32_Note_header_t)) {
+        at_end = true;
+        return;
+      }
+
+      Elf32_Note_header_t header;
+      std::memcpy(&header, notes.data() + next, sizeof(header));
+      if(view->foreign) {
+        header.name_sz = byteswap(header.name_sz);
+        header.desc_sz = byteswap(header.desc_sz);
+        header.type = byteswap(header.type);
+      }
+
+      const auto name = next + sizeof(header);
+      const auto desc = padded(name + header.name_sz);
+      if(desc > notes.size() || header.desc_sz > notes.size() - desc) {
+        at_end = true;
+        return;
+      }
+
+      const std::string_view name_sz{reinterpret_cast<const char *>(notes.data() + name), header.name_sz};
+      note = {name_sz.substr(0, name_sz.find('\0')), header.type, notes.subspan(desc, header.desc_sz), view->foreign};
+      next = std::min(padded(desc + header.desc_sz), notes.size());
+    }
+
+  public:
+    using iterator_concept = std::input_iterator_tag;
+    using value_type = Note_t;
+    using difference_type = std::ptrdiff_t;
+
+    iterator() noexcept = default;
+    explicit iterator(const NoteView *view) noexcept : view{view} {
+      advance();
+    }
+
+    auto operator*() const noexcept -> const Note_t & {
+      return note;
+    }
+
+    auto operator++() noexcept -> iterator & {
+      advance();
+      return *this;
+    }
+
+    void operator++(int) noexcept {
+      advance();
+    }
+
+    friend auto operator==(const iterator &it, std::default_sentinel_t) noexcept -> bool {
+      return it.at_end;
+    }
+  };
+
+  NoteView() noexcept = default;
+  NoteView(std::span<const Elf_byte> notes, const std::size_t alignment, const bool foreign) noexcept :
+      notes{notes},
+      alignment{alignment == 8 ? std::size_t{8} : std::size_t{4}},
+      foreign{foreign} {}
+
+  [[nodiscard]] auto name() const noexcept -> std::string_view {
+    return section_name;
+  }
+
+  [[nodiscard]] auto offset() const noexcept -> std::size_t {
+    return section_offset;
+  }
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t { // in bytes
+    return notes.size();
+  }
+
+  [[nodiscard]] auto begin() const noexcept -> iterator {
+    return iterator{this};
+  }
+
+  [[nodiscard]] auto end() const noexcept -> std::default_sentinel_t {
+    return std::default_sentinel;
+  }
+};
+
+template <typename Class, std::endian Order>
+class ElfFile;
+
+// Every FileHeader owns its file, or views an image someone else owns, different instances can be used from different
+// threads at the same time. open() and decode() modify the instance, const member functions are safe to call
+// concurrently once decoded.
 class FileHeader {
+  MappedFile file;
+  std::span<const Elf_byte> image_view; // of file, or of the image given to open()
   Elf_Header_t elf_header;
   std::vector<Program_Header_t> program_headers;
-  std::map<std::string, Section_Header_t> section_headers;
+  std::vector<Section_t> section_headers;                          // in section header table order, [Nr] is the index
+  std::unordered_map<std::string_view, std::size_t> section_index; // name -> index of the first section with that name
+
+  // File backed part of the PT_LOAD segments, sorted by address
+  struct Load {
+    std::size_t vaddr;
+    std::size_t offset;
+    std::size_t filesz;
+  };
+  std::vector<Load> loads;
+
+  // String tables, viewed in place in the file image
+  std::string_view shstrtab_view;
+  std::string_view strtab_view;
+  std::string_view dynstr_view;
+
+  // Files in the other byte order than the host's: tables byte-swapped by decode(), keyed by their file offset. A
+  // table with entries too small to swap is kept empty, so it reads as empty rather than in the wrong byte order
+  bool foreign_byte_order = false;
+  std::unordered_map<std::size_t, std::vector<Elf_byte>> swapped_tables;
+
+  template <typename Class, std::endian Order>
+  friend class ElfFile;
 
 public:
   [[nodiscard]] auto open(const char *file) noexcept -> bool;
+  // Views an image already in memory, e.g. a member inside the mapping of an archive. Nothing is copied, the image
+  // must outlive the FileHeader
+  [[nodiscard]] auto open(std::span<const Elf_byte> image) noexcept -> bool;
   void decode() noexcept;
 
+  // Calls visitor with the ElfFile matching the file's class and byte order. The choice is made once here, so the
+  // visitor's table walks are compiled separately for each kind of file, without a std::visit per entry.
+  template <typename Visitor>
+  decltype(auto) visit(Visitor &&visitor) const;
+
+  [[nodiscard]] auto bytes() const noexcept -> std::span<const Elf_byte>; // whole file image
+
   // clang-format off
   [[nodiscard]] auto identificationArray() const noexcept -> std::span<const Elf_byte>; // ident
   [[nodiscard]] auto fileClass()           const noexcept -> std::string_view;    // ident[i_class]
@@ -229,11 +877,30 @@ public:
 
   [[nodiscard]] auto programHeaders() const noexcept -> const decltype(program_headers) &;
   [[nodiscard]] auto sectionHeaders() const noexcept -> const decltype(section_headers) &;
+  [[nodiscard]] auto findSection(std::string_view name) const noexcept -> const Section_t *; // nullptr if there is none
   [[nodiscard]] auto symbols()        const noexcept -> const std::vector<Symbol_t>;
   [[nodiscard]] auto dynamicSymbols() const noexcept -> const std::vector<Symbol_t>;
-  [[nodiscard]] auto notes()          const noexcept -> const std::map<std::string, std::tuple<std::string, std::size_t, std::string>>;
 
-  [[nodiscard]] auto relocations()    const noexcept -> const std::map<std::pair<std::string, std::size_t>, std::vector<std::tuple<std::size_t, std::size_t, std::string_view, std::size_t, std::string>>>;
+  // In-place views of .symtab and .dynsym, empty if the file has none. Cheap to call, nothing is copied up front
+  [[nodiscard]] auto symbolTable()        const noexcept -> Symbol_Table_t;
+  [[nodiscard]] auto dynamicSymbolTable() const noexcept -> Symbol_Table_t;
+  // Exported symbol with that name, found through .gnu.hash or .hash, see ElfFile::findDynamicSymbol()
+  [[nodiscard]] auto findDynamicSymbol(std::string_view name) const noexcept -> std::optional<Symbol_t>;
+  // SHT_NOTE sections in table order, or the PT_NOTE segments of files without note sections
+  [[nodiscard]] auto notes()          const noexcept -> std::vector<NoteView>;
+  // Descriptor of the GNU build-id note, empty if there is none. Only the ELF header, the program headers and the
+  // PT_NOTE segments are read (the section headers for files without program headers), decode() isn't needed
+  [[nodiscard]] auto buildId()        const noexcept -> std::span<const Elf_byte>;
+
+  // SHT_REL and SHT_RELA sections in table order, symbols joined through sh_link
+  [[nodiscard]] auto relocations()    const noexcept -> std::vector<Relocation_Section_t>;
+  // Same sections, entries decoded on demand. Views stay valid until the file is closed or another one is opened
+  [[nodiscard]] auto relocationTables() const noexcept -> std::vector<RelocationView>;
+  // Entries of .dynamic, or of the PT_DYNAMIC segment when there are no section headers, up to and including DT_NULL
+  [[nodiscard]] auto dynamic() const noexcept -> std::vector<Dynamic_t>;
+
+  // SHT_RELR sections in table order
+  [[nodiscard]] auto relativeRelocationTables() const noexcept -> std::vector<RelrView>;
 
   [[nodiscard]] auto flags()      const noexcept -> int;
   [[nodiscard]] auto headerSize() const noexcept -> int;
@@ -244,19 +911,338 @@ public:
   [[nodiscard]] auto sectionHeaderEntrySize() const noexcept -> std::size_t;
   [[nodiscard]] auto numSectionHeaders() const noexcept -> int;
   [[nodiscard]] auto sectionHeaderStringTableIndex() const noexcept -> int;
-  [[nodiscard]] auto getSymbolName(const std::size_t name) const noexcept -> std::string;
-  [[nodiscard]] auto getDynamicSymbolName(const std::size_t name) const noexcept -> std::string;
+
+  // File offset of the byte loaded at a virtual address, nullopt if no PT_LOAD segment loads it from the file (bss,
+  // or an address outside every segment). O(log n) in the number of segments
+  [[nodiscard]] auto vaddrToOffset(const std::size_t vaddr) const noexcept -> std::optional<std::size_t>;
+
+  // The length bytes loaded at vaddr, viewed in place in the file image. Empty unless all of them come from the file
+  // and from the same segment. Bytes are as they are in the file, in its byte order
+  [[nodiscard]] auto readAtVirtualAddress(const std::size_t vaddr, const std::size_t length) const noexcept
+      -> std::span<const Elf_byte>;
+
+  // Names point into the file image, they stay valid until the file is closed or another one is opened
+  [[nodiscard]] auto getSymbolName(const std::size_t name) const noexcept -> std::string_view;        // .strtab
+  [[nodiscard]] auto getDynamicSymbolName(const std::size_t name) const noexcept -> std::string_view; // .dynstr
 
 private:
+  void swapTables();
+  // nullopt if nothing at offset was swapped, e.g. a string table, which is then read from the image as it is
+  [[nodiscard]] auto swappedTable(const std::size_t offset) const noexcept
+      -> std::optional<std::span<const Elf_byte>>;
+
+  [[nodiscard]] auto symbolTableOf(const Section_t *section) const noexcept -> Symbol_Table_t;
+
   [[nodiscard]] auto isELF()   const noexcept -> bool;
   [[nodiscard]] auto is64bit() const noexcept -> bool;
 };
 
+// What the headers of a file tell about it, see probe()
+struct Probe_t {
+  std::string_view file_class{}; // the strings of the FileHeader accessors with the same name
+  std::string_view data_encoding{};
+  std::string_view os_abi{};
+  std::string_view type{};
+  std::string_view machine{};
+  bool big_endian = false;
+  bool pie = false;      // ET_DYN with a PT_INTERP segment, an executable rather than a shared library
+  bool stripped = false; // no SHT_SYMTAB section
+};
+
+// Classifies a file without mapping it. The ELF header and the program headers are read from the first page with one
+// read, and whether it is stripped from the section header table alone, usually at the end of the file.
+// nullopt if the file can't be read or isn't ELF
+[[nodiscard]] auto probe(const char *file) noexcept -> std::optional<Probe_t>;
+// Same for an image already in memory, e.g. a member of an archive
+[[nodiscard]] auto probe(std::span<const Elf_byte> image) noexcept -> std::optional<Probe_t>;
+
+// probe() of every file, in the same order. On Linux the first pages of many files are read with one io_uring
+// submission, then their section header tables with another, instead of a pread at a time. Elsewhere, or where
+// io_uring is disabled, the files are probed one by one
+[[nodiscard]] auto probeAll(std::span<const std::string> files) -> std::vector<std::optional<Probe_t>>;
+
+// Decoded file seen as one specific class and byte order, obtained through FileHeader::visit(). Tables are viewed in
+// place in the file image. Valid as long as the FileHeader it comes from.
+template <typename Class, std::endian Order>
+class ElfFile {
+  const FileHeader *file;
+  const typename Class::Header *elf_header;
+
+public:
+  using class_type = Class;
+  using Header = typename Class::Header;
+  using Program_Header = typename Class::Program_Header;
+  using Section_Header = typename Class::Section_Header;
+  using Symbol = typename Class::Symbol;
+
+  static constexpr bool is_64bit = std::is_same_v<Class, Elf64>;
+  static constexpr std::endian byte_order = Order;
+
+  explicit ElfFile(const FileHeader &file) noexcept :
+      file{&file},
+      elf_header{&std::get<Header>(file.elf_header)} {}
+
+  [[nodiscard]] auto header() const noexcept -> const Header & {
+    return *elf_header;
+  }
+
+  [[nodiscard]] auto bytes() const noexcept -> std::span<const Elf_byte> {
+    return file->bytes();
+  }
+
+  // Integer stored at offset in the file's byte order, 0 past the end of the image
+  template <std::integral T>
+  [[nodiscard]] auto read(const std::size_t offset) const noexcept -> T {
+    const auto image = bytes();
+    if(offset > image.size() || image.size() - offset < sizeof(T)) return T{};
+
+    T value;
+    std::memcpy(&value, image.data() + offset, sizeof(T));
+    if constexpr(Order != std::endian::native) value = byteswap(value);
+    return value;
+  }
+
+  [[nodiscard]] auto programHeaders() const noexcept -> TableView<Program_Header> {
+    return table<Program_Header>(elf_header->phOffset, std::size_t{elf_header->phNumber} * elf_header->phEntrySize,
+                                 elf_header->phEntrySize);
+  }
+
+  [[nodiscard]] auto sectionHeaders() const noexcept -> TableView<Section_Header> {
+    return table<Section_Header>(elf_header->shOffset, std::size_t{elf_header->shNumber} * elf_header->shEntrySize,
+                                 elf_header->shEntrySize);
+  }
+
+  // nullptr if there is no section with that name
+  [[nodiscard]] auto findSection(std::string_view name) const noexcept -> const Section_Header * {
+    const auto *section = file->findSection(name);
+    return section ? std::get_if<Section_Header>(&section->header) : nullptr;
+  }
+
+  // nullptr if the index is past the section header table
+  [[nodiscard]] auto section(const std::size_t index) const noexcept -> const Section_Header * {
+    if(index >= file->section_headers.size()) return nullptr;
+    return &std::get<Section_Header>(file->section_headers[index].header);
+  }
+
+  [[nodiscard]] auto sectionName(const Section_Header &section) const noexcept -> std::string_view {
+    return stringAt(file->shstrtab_view, section.name);
+  }
+
+  // String table a section refers to through sh_link, e.g. .strtab for .symtab
+  [[nodiscard]] auto linkedStrings(const Section_Header &section) const noexcept -> std::string_view {
+    const auto *strings = this->section(section.link);
+    if(strings == nullptr || strings->type != 3) return {};
+
+    const auto data = sectionData(*strings);
+    return {reinterpret_cast<const char *>(data.data()), data.size()};
+  }
+
+  // Contents of a section, empty for SHT_NOBITS. Tables come already byte-swapped for files in the other byte order
+  [[nodiscard]] auto sectionData(const Section_Header &section) const noexcept -> std::span<const Elf_byte> {
+    if(section.type == 8) return {};
+    return table(section.offset, section.size);
+  }
+
+  // Entries of a section holding a table, e.g. table<Elf64_Rela_t>(rela_section)
+  template <typename T>
+  [[nodiscard]] auto table(const Section_Header &section) const noexcept -> TableView<T> {
+    return {sectionData(section), section.entsize};
+  }
+
+  [[nodiscard]] auto symbolTable() const noexcept -> TableView<Symbol> {
+    const auto *symtab = findSection(".symtab");
+    return symtab ? table<Symbol>(*symtab) : TableView<Symbol>{};
+  }
+
+  [[nodiscard]] auto dynamicSymbolTable() const noexcept -> TableView<Symbol> {
+    const auto *dynsym = findSection(".dynsym");
+    return dynsym ? table<Symbol>(*dynsym) : TableView<Symbol>{};
+  }
+
+  [[nodiscard]] auto symbolName(const Symbol &symbol) const noexcept -> std::string_view {
+    return stringAt(file->strtab_view, symbol.name);
+  }
+
+  [[nodiscard]] auto dynamicSymbolName(const Symbol &symbol) const noexcept -> std::string_view {
+    return stringAt(file->dynstr_view, symbol.name);
+  }
+
+  // Symbol .dynsym exports under name, looked up the way the dynamic loader does: through the bloom filter and
+  // buckets of .gnu.hash, or the buckets of .hash when there is no .gnu.hash. Undefined symbols are not exports
+  [[nodiscard]] auto findDynamicSymbol(std::string_view name) const noexcept -> std::optional<Symbol> {
+    const auto symbols = dynamicSymbolTable();
+    if(symbols.empty()) return std::nullopt;
+
+    const auto matches = [&](const std::size_t index) -> std::optional<Symbol> {
+      if(index >= symbols.size()) return std::nullopt;
+      const auto symbol = symbols[index];
+      if(symbol.shndx == 0 || dynamicSymbolName(symbol) != name) return std::nullopt;
+      return symbol;
+    };
+
+    if(const auto *gnu_hash = findSection(".gnu.hash")) {
+      using Bloom_word = typename Class::Addr;
+      constexpr std::uint32_t bloom_bits = sizeof(Bloom_word) * 8;
+
+      const std::size_t at = gnu_hash->offset;
+      const auto nbuckets = read<std::uint32_t>(at);
+      const auto symoffset = read<std::uint32_t>(at + 4);
+      const auto bloom_size = read<std::uint32_t>(at + 8);
+      const auto bloom_shift = read<std::uint32_t>(at + 12);
+      if(nbuckets == 0 || bloom_size == 0) return std::nullopt;
+
+      const auto bloom = at + 16;
+      const auto buckets = bloom + std::size_t{bloom_size} * sizeof(Bloom_word);
+      const auto chains = buckets + std::size_t{nbuckets} * 4;
+
+      // Most names a library does not export stop at the bloom filter, before any symbol is read
+      const auto hash = gnuHash(name);
+      const auto word = read<Bloom_word>(bloom + ((hash / bloom_bits) % bloom_size) * sizeof(Bloom_word));
+      const auto mask =
+          (Bloom_word{1} << (hash % bloom_bits)) | (Bloom_word{1} << ((hash >> bloom_shift) % bloom_bits));
+      if((word & mask) != mask) return std::nullopt;
+
+      auto index = read<std::uint32_t>(buckets + (hash % nbuckets) * 4);
+      if(index < symoffset) return std::nullopt;
+
+      // Chains hold the hashes of the symbols of a bucket, the last one has its low bit set
+      for(; index < symbols.size(); ++index) {
+        const auto chain_hash = read<std::uint32_t>(chains + std::size_t{index - symoffset} * 4);
+        if((hash | 1) == (chain_hash | 1)) {
+          if(auto symbol = matches(index)) return symbol;
+        }
+        if(chain_hash & 1) break;
+      }
+      return std::nullopt;
+    }
+
+    if(const auto *hash_table = findSection(".hash")) {
+      // Words are 8 bytes wide on a few 64-bit targets, as the section's entsize tells
+      const auto word = [&, entsize = hash_table->entsize](const std::size_t i) -> std::size_t {
+        if(entsize == 8) return read<std::uint64_t>(hash_table->offset + i * 8);
+        return read<std::uint32_t>(hash_table->offset + i * 4);
+      };
+
+      const auto nbucket = word(0);
+      const auto nchain = word(1);
+      if(nbucket == 0) return std::nullopt;
+
+      // Chains are as long as the symbol table, a longer walk means the table is corrupt
+      std::size_t steps = 0;
+      for(auto index = word(2 + elfHash(name) % nbucket); index != 0 && index < nchain && steps != nchain; ++steps) {
+        if(auto symbol = matches(index)) return symbol;
+        index = word(2 + nbucket + index);
+      }
+    }
+
+    return std::nullopt;
+  }
+
+private:
+  template <typename T>
+  [[nodiscard]] auto table(const std::size_t offset, const std::size_t size, const std::size_t entsize) const noexcept
+      -> TableView<T> {
+    if(offset == 0) return {};
+    return {table(offset, size), entsize};
+  }
+
+  [[nodiscard]] auto table(const std::size_t offset, const std::size_t size) const noexcept
+      -> std::span<const Elf_byte> {
+    if constexpr(Order != std::endian::native) {
+      // Only the size asked for, another section may start at the same offset, e.g. an empty one
+      if(const auto swapped = file->swappedTable(offset)) return swapped->first(std::min(size, swapped->size()));
+    }
+
+    const auto image = bytes();
+    if(offset >= image.size()) return {};
+    return image.subspan(offset, std::min(size, image.size() - offset));
+  }
+
+  [[nodiscard]] static auto stringAt(std::string_view table, const std::size_t offset) noexcept -> std::string_view {
+    if(offset >= table.size()) return {};
+    table.remove_prefix(offset);
+    return table.substr(0, table.find('\0'));
+  }
+};
+
+template <typename Visitor>
+decltype(auto) FileHeader::visit(Visitor &&visitor) const {
+  const bool big_endian = identificationArray()[i_data] == 2;
+
+  if(std::holds_alternative<Elf64_Header_t>(elf_header)) {
+    if(big_endian) return std::forward<Visitor>(visitor)(ElfFile<Elf64, std::endian::big>{*this});
+    return std::forward<Visitor>(visitor)(ElfFile<Elf64, std::endian::little>{*this});
+  }
+
+  if(big_endian) return std::forward<Visitor>(visitor)(ElfFile<Elf32, std::endian::big>{*this});
+  return std::forward<Visitor>(visitor)(ElfFile<Elf32, std::endian::little>{*this});
+}
+
+// What an address resolves to in a SymbolIndex
+struct Symbolized_t {
+  std::string_view name; // empty if no symbol covers the address
+  std::size_t offset;    // from the start of the symbol
+};
+
+// Address to symbol lookup over the STT_FUNC, STT_OBJECT and STT_GNU_IFUNC symbols of .symtab and .dynsym. Built once
+// from a decoded file, names point into its image so the index is valid as long as the file stays open.
+// A symbol covers [value, value + size), a symbol of size 0 extends up to the next symbol. Of aliases the global one
+// wins over a weak one over a local one, and a symbol nested in another one covers its own range only
+class SymbolIndex {
+  struct Range {
+    std::size_t end;
+    std::size_t value;
+    std::string_view name;
+  };
+
+  // Disjoint intervals sorted by start, starts are kept apart so the searches only touch them
+  std::vector<std::size_t> starts;
+  std::vector<Range> ranges;
+
+  [[nodiscard]] auto resolve(const std::size_t i, const std::size_t address) const noexcept -> Symbolized_t {
+    if(i == ranges.size() || address < starts[i] || address >= ranges[i].end) return {{}, 0};
+    return {ranges[i].name, address - ranges[i].value};
+  }
+
+  // Index of the last interval starting at or before address, ranges.size() if there is none
+  [[nodiscard]] auto find(const std::size_t address) const noexcept -> std::size_t;
+
+public:
+  SymbolIndex() noexcept = default;
+  explicit SymbolIndex(const FileHeader &file);
+
+  [[nodiscard]] auto lookup(const std::size_t address) const noexcept -> Symbolized_t {
+    return resolve(find(address), address);
+  }
+
+  // results[i] is what addresses[i] resolves to, results must be as large as addresses. Sorted addresses are resolved
+  // in one forward walk over the index
+  void lookup(std::span<const std::size_t> addresses, std::span<Symbolized_t> results) const noexcept;
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t {
+    return ranges.size();
+  }
+
+  [[nodiscard]] auto empty() const noexcept -> bool {
+    return ranges.empty();
+  }
+};
+
+[[nodiscard]] auto getFileClass(const Elf_byte classData) noexcept -> std::string_view;
+[[nodiscard]] auto getDataEncoding(const Elf_byte encodingData) noexcept -> std::string_view;
+[[nodiscard]] auto getOSABI(const Elf_byte osABI) noexcept -> std::string_view;
+[[nodiscard]] auto getFileType(const std::size_t fileType) noexcept -> std::string_view;
+[[nodiscard]] auto getMachine(const std::size_t machine) noexcept -> std::string_view;
+
 [[nodiscard]] auto getProgramHeaderType(const std::size_t phType) noexcept -> std::string_view;
-[[nodiscard]] auto getProgramHeaderFlag(const std::size_t phFlag) noexcept -> std::string_view;
+[[nodiscard]] auto getProgramHeaderFlag(const std::size_t phFlag) noexcept -> std::string;
 
 [[nodiscard]] auto getSectionHeaderType(const std::size_t shType) noexcept -> std::string_view;
-[[nodiscard]] auto getSectionHeaderFlag(const std::size_t shFlag) noexcept -> std::string_view;
+[[nodiscard]] auto getSectionHeaderFlag(const std::size_t shFlag) noexcept -> std::string;
+
+[[nodiscard]] auto getDynamicTag(const std::int64_t tag) noexcept -> std::string_view;
+
+[[nodiscard]] auto getNoteType(std::string_view owner, const std::uint32_t type) noexcept -> std::string_view;
 
 [[nodiscard]] auto getSymbolType(const Elf_byte symInfo) noexcept -> std::string_view;
 [[nodiscard]] auto getSymbolBind(const Elf_byte symInfo) noexcept -> std::string_view;
@@ -264,3 +1250,6 @@ private:
 [[nodiscard]] auto getSymbolIndex(const Elf_byte symIndex) noexcept -> std::string;
 
 } // namespace feelelf
+
+template <typename T>
+inline constexpr bool std::ranges::enable_borrowed_range<feelelf::TableView<T>> = true;
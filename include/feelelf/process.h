@@ -0,0 +1,88 @@
+#pragma once
+
+#include <feelelf/feelelf.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace feelelf {
+
+// A file backed mapping of a process, one line of /proc/<pid>/maps
+struct Mapping_t {
+  std::size_t start; // [start, end) in the address space of the process
+  std::size_t end;
+  std::size_t offset; // file offset mapped at start
+  std::uint64_t device;
+  std::uint64_t inode;
+  std::string path;
+};
+
+// File backed mappings of a process sorted by address, empty if its maps can't be read (or the platform has no /proc)
+[[nodiscard]] auto readProcessMaps(int pid) -> std::vector<Mapping_t>;
+
+// What a runtime address of a process resolves to
+struct Process_Symbolized_t {
+  std::string_view module; // path of the mapped file, empty if the address isn't in a file backed mapping
+  std::size_t address;     // link time address in module
+  std::string_view name;   // empty if no symbol covers the address
+  std::size_t offset;      // from the start of the symbol
+};
+
+// Symbolizes addresses of live processes. The ELF files backing their mappings are opened and indexed once, and
+// shared by every process and every query mapping them. When a call starts with more than capacity files open, the
+// least recently used ones are closed. Runtime addresses are turned into link time ones through the PT_LOAD segments.
+// Not thread safe, a profiling agent sampling on several threads gives each its own symbolizer or locks around it
+class ProcessSymbolizer {
+  struct Object;
+
+  struct Key {
+    std::uint64_t device;
+    std::uint64_t inode;
+
+    friend auto operator==(const Key &, const Key &) noexcept -> bool = default;
+  };
+
+  struct KeyHash {
+    auto operator()(const Key &key) const noexcept -> std::size_t {
+      return std::hash<std::uint64_t>{}(key.device * 0x9e3779b97f4a7c15 ^ key.inode);
+    }
+  };
+
+  struct Entry {
+    Key key;
+    std::string path;
+    std::unique_ptr<Object> object; // nullptr for files that couldn't be opened as ELF, so they aren't tried again
+  };
+
+  std::size_t capacity;
+  std::list<Entry> recently_used; // most recently used first
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> cached;
+
+  auto entry(const Mapping_t &mapping) -> const Entry &;
+  void evict();
+
+public:
+  explicit ProcessSymbolizer(std::size_t capacity = 64);
+  ProcessSymbolizer(const ProcessSymbolizer &) = delete;
+  auto operator=(const ProcessSymbolizer &) -> ProcessSymbolizer & = delete;
+  ~ProcessSymbolizer();
+
+  // results[i] is what addresses[i] resolves to in process pid, results must be as large as addresses. The maps of
+  // the process are read on every call as it may have loaded or unloaded libraries since the last one.
+  // Names in the results stay valid until the next call
+  void symbolize(int pid, std::span<const std::size_t> addresses, std::span<Process_Symbolized_t> results);
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t {
+    return cached.size();
+  }
+};
+
+} // namespace feelelf
@@ -0,0 +1,156 @@
+#include <feelelf/archive.h>
+
+#include <charconv>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <system_error>
+
+namespace feelelf {
+
+namespace {
+constexpr std::string_view archive_magic = "!<arch>\n";
+constexpr std::string_view thin_magic = "!<thin>\n";
+
+// ar_hdr, ASCII fields padded with spaces. Only characters, so it is viewed in place at any offset
+struct Member_Header {
+  char name[16];
+  char date[12];
+  char uid[6];
+  char gid[6];
+  char mode[8];
+  char size[10];
+  char magic[2]; // "`\n"
+};
+static_assert(sizeof(Member_Header) == 60);
+
+// What the header at some offset of an archive tells
+struct Raw_Member {
+  std::string_view name; // as it is in the header, trailing spaces removed
+  std::size_t data;      // offset of the contents in the archive
+  std::size_t size;
+};
+
+auto text(std::span<const Elf_byte> bytes) noexcept -> std::string_view {
+  return {reinterpret_cast<const char *>(bytes.data()), bytes.size()};
+}
+
+auto field(const char *begin, const std::size_t size) noexcept -> std::string_view {
+  const std::string_view padded{begin, size};
+  return padded.substr(0, padded.find_last_not_of(' ') + 1);
+}
+
+auto number(std::string_view decimal) noexcept -> std::optional<std::size_t> {
+  std::size_t value = 0;
+  const auto [end, error] = std::from_chars(decimal.data(), decimal.data() + decimal.size(), value);
+  if(error != std::errc{} || end != decimal.data() + decimal.size()) return std::nullopt;
+  return value;
+}
+
+// nullopt past the end of the archive, or if the header is malformed
+auto headerAt(std::span<const Elf_byte> image, const std::size_t offset) noexcept -> std::optional<Raw_Member> {
+  if(offset > image.size() || image.size() - offset < sizeof(Member_Header)) return std::nullopt;
+
+  const auto &header = *reinterpret_cast<const Member_Header *>(image.data() + offset);
+  if(header.magic[0] != '`' || header.magic[1] != '\n') return std::nullopt;
+
+  const auto size = number(field(header.size, sizeof(header.size)));
+  if(!size) return std::nullopt;
+  return Raw_Member{field(header.name, sizeof(header.name)), offset + sizeof(Member_Header), *size};
+}
+
+// GNU "/" and "/SYM64/", BSD "__.SYMDEF" and "__.SYMDEF SORTED"
+auto isSymbolTable(std::string_view name) noexcept -> bool {
+  return name == "/" || name == "/SYM64/" || name.starts_with("__.SYMDEF");
+}
+
+// Symbol tables, the long name table and whatever else GNU names "/" followed by other than an offset
+auto isSpecial(std::string_view name) noexcept -> bool {
+  return isSymbolTable(name) || (name.starts_with('/') && !number(name.substr(1)));
+}
+} // namespace
+
+auto isArchive(std::span<const Elf_byte> bytes) noexcept -> bool {
+  if(bytes.size() < Archive::magic_size) return false;
+
+  const auto magic = text(bytes.first(Archive::magic_size));
+  return magic == archive_magic || magic == thin_magic;
+}
+
+auto Archive::open(const char *path) noexcept -> bool {
+  long_names = {};
+  thin = false;
+
+  if(!file.open(path) || !isArchive(file.bytes())) {
+    file.close();
+    return false;
+  }
+
+  const auto image = file.bytes();
+  thin = text(image.first(magic_size)) == thin_magic;
+
+  // The long name table follows the symbol tables, ahead of every member naming into it
+  for(auto offset = magic_size; const auto raw = headerAt(image, offset);) {
+    if(raw->size > image.size() - raw->data) break;
+
+    if(raw->name == "//") {
+      long_names = text(image.subspan(raw->data, raw->size));
+      break;
+    }
+    if(!isSpecial(raw->name)) break;
+    offset = raw->data + raw->size + (raw->size & 1); // contents are padded to an even size
+  }
+  return true;
+}
+
+auto Archive::bytes() const noexcept -> std::span<const Elf_byte> {
+  return file.bytes();
+}
+
+auto Archive::read(std::size_t offset, Archive_Member_t &member) const noexcept -> std::size_t {
+  const auto image = file.bytes();
+
+  while(const auto raw = headerAt(image, offset)) {
+    // Thin archives hold the contents of their symbol and long name tables, and only those
+    const bool special = isSpecial(raw->name);
+    const bool stored = special || !thin;
+    if(stored && raw->size > image.size() - raw->data) return 0;
+
+    const auto following = stored ? raw->data + raw->size + (raw->size & 1) : raw->data;
+    if(special) {
+      offset = following;
+      continue;
+    }
+
+    auto name = raw->name;
+    auto contents = stored ? image.subspan(raw->data, raw->size) : std::span<const Elf_byte>{};
+    if(name.starts_with("#1/")) { // BSD, the name is the first bytes of the contents
+      const auto length = number(name.substr(3));
+      if(!length || *length > contents.size()) return 0;
+
+      name = text(contents.first(*length));
+      name = name.substr(0, name.find('\0')); // padded with NULs
+      contents = contents.subspan(*length);
+      if(isSymbolTable(name)) {
+        offset = following;
+        continue;
+      }
+    }
+    else if(name.starts_with('/')) { // GNU, an offset into the long name table
+      const auto at = *number(name.substr(1));
+      if(at >= long_names.size()) return 0;
+
+      name = long_names.substr(at);
+      name = name.substr(0, name.find('\n'));
+      if(name.ends_with('/')) name.remove_suffix(1);
+    }
+    else if(name.ends_with('/')) name.remove_suffix(1); // GNU short names end with a '/'
+
+    member = {name, offset, stored ? contents.size() : raw->size, contents};
+    return following;
+  }
+  return 0;
+}
+
+} // namespace feelelf
@@ -0,0 +1,173 @@
+#include <feelelf/cache.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace feelelf {
+
+namespace {
+constexpr std::array<char, 8> magic{'f', 'e', 'e', 'l', 'e', 'l', 'f', 'C'};
+constexpr std::uint32_t version = 1;
+constexpr std::uint32_t byte_order = 0x01020304; // reads back differently on a machine of the other byte order
+
+struct Header {
+  std::array<char, 8> magic;
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint64_t count;
+};
+
+// Records are offset bytes from the start of the cache file
+struct Entry {
+  File_Key_t file;
+  std::uint64_t tag;
+  std::uint64_t offset;
+  std::uint64_t length;
+};
+
+static_assert(sizeof(Header) == 24 && sizeof(Entry) == 56, "the cache file layout has no padding");
+} // namespace
+
+auto fileKey(const char *path) noexcept -> std::optional<File_Key_t> {
+#if defined(_WIN32)
+  (void)path;
+  return std::nullopt;
+#else
+  struct stat st {};
+  if(::stat(path, &st) == -1) return std::nullopt;
+
+#if defined(__APPLE__)
+  const auto &mtime = st.st_mtimespec;
+#else
+  const auto &mtime = st.st_mtim;
+#endif
+
+  return File_Key_t{.device = static_cast<std::uint64_t>(st.st_dev),
+                    .inode = static_cast<std::uint64_t>(st.st_ino),
+                    .size = static_cast<std::uint64_t>(st.st_size),
+                    .mtime = static_cast<std::int64_t>(mtime.tv_sec) * 1'000'000'000 + mtime.tv_nsec};
+#endif
+}
+
+auto MetadataCache::open(const char *path) noexcept -> bool {
+  file.close();
+  count = 0;
+  added.clear();
+
+  if(!file.open(path)) return false;
+
+  const auto bytes = file.bytes();
+  Header header{};
+  if(bytes.size() >= sizeof(Header)) std::memcpy(&header, bytes.data(), sizeof(Header));
+
+  if(header.magic != magic || header.version != version || header.byte_order != byte_order ||
+     header.count > (bytes.size() - sizeof(Header)) / sizeof(Entry)) {
+    file.close();
+    return false;
+  }
+
+  count = header.count;
+  return true;
+}
+
+auto MetadataCache::find(const File_Key_t &key, const std::uint64_t tag) const noexcept
+    -> std::optional<std::string_view> {
+  const auto bytes = file.bytes();
+  const TableView<Entry> entries{bytes.subspan(sizeof(Header), count * sizeof(Entry)), sizeof(Entry)};
+
+  const Key wanted{key, tag};
+  const auto it = std::ranges::lower_bound(entries, wanted, {}, [](const Entry &e) { return Key{e.file, e.tag}; });
+  if(it == entries.end()) return std::nullopt;
+
+  const Entry entry = *it;
+  if(Key{entry.file, entry.tag} != wanted) return std::nullopt;
+  if(entry.offset > bytes.size() || entry.length > bytes.size() - entry.offset) return std::nullopt;
+
+  return std::string_view{reinterpret_cast<const char *>(bytes.data() + entry.offset), entry.length};
+}
+
+void MetadataCache::put(const File_Key_t &key, const std::uint64_t tag, std::string_view record) {
+  added.insert_or_assign(Key{key, tag}, std::string{record});
+}
+
+auto MetadataCache::save(const char *path) const -> bool {
+  struct Saved {
+    Key key;
+    std::string_view record;
+  };
+  std::vector<Saved> saved;
+
+  // A file put under another size or mtime than the cached one has changed, the rest cached about it is stale
+  std::map<std::pair<std::uint64_t, std::uint64_t>, const File_Key_t *> current; // by device and inode
+  for(const auto &[key, record] : added) {
+    current.emplace(std::pair{key.file.device, key.file.inode}, &key.file);
+    saved.push_back({key, record});
+  }
+
+  const auto bytes = file.bytes();
+  for(std::size_t i = 0; i != count; ++i) {
+    Entry entry;
+    std::memcpy(&entry, bytes.data() + sizeof(Header) + i * sizeof(Entry), sizeof(Entry));
+
+    const Key key{entry.file, entry.tag};
+    if(added.contains(key)) continue;
+    const auto it = current.find({entry.file.device, entry.file.inode});
+    if(it != current.end() && *it->second != entry.file) continue;
+    if(entry.offset > bytes.size() || entry.length > bytes.size() - entry.offset) continue;
+
+    saved.push_back({key, {reinterpret_cast<const char *>(bytes.data() + entry.offset), entry.length}});
+  }
+
+  std::ranges::sort(saved, {}, &Saved::key);
+
+#if defined(_WIN32)
+  const std::string temporary = std::string{path} + ".tmp";
+#else
+  const std::string temporary = std::string{path} + ".tmp" + std::to_string(::getpid());
+#endif
+
+  {
+    std::ofstream out{temporary, std::ios::binary | std::ios::trunc};
+
+    const Header header{magic, version, byte_order, saved.size()};
+    out.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+
+    std::uint64_t offset = sizeof(Header) + saved.size() * sizeof(Entry);
+    for(const auto &[key, record] : saved) {
+      const Entry entry{key.file, key.tag, offset, record.size()};
+      out.write(reinterpret_cast<const char *>(&entry), sizeof(Entry));
+      offset += record.size();
+    }
+
+    for(const auto &[key, record] : saved)
+      out.write(record.data(), static_cast<std::streamsize>(record.size()));
+
+    if(!out.flush()) {
+      out.close();
+      std::remove(temporary.c_str());
+      return false;
+    }
+  }
+
+#if defined(_WIN32)
+  std::remove(path); // rename doesn't replace files there
+#endif
+  if(std::rename(temporary.c_str(), path) != 0) {
+    std::remove(temporary.c_str());
+    return false;
+  }
+  return true;
+}
+
+} // namespace feelelf
@@ -1,36 +1,587 @@
 #include <feelelf/feelelf.h>
 
+#include "io_uring.h"
+
 #include <algorithm>
 #include <array>
+#include <bit>
+#include <cstddef>
 #include <cstdint>
-#include <fstream>
+#include <cstring>
 #include <map>
+#include <new>
+#include <optional>
 #include <ranges>
-#include <sstream>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
+#if defined(_WIN32)
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace feelelf {
 
 std::string_view i386_relocation_type(unsigned int type);
 std::string_view amd64_relocation_type(unsigned int type);
 std::string_view aarch64_relocation_type(unsigned int type);
 
+std::string_view unknown_relocation_type(unsigned int) {
+  return "Unknown";
+}
+
 // clang-format off
 template <class... Ts> struct overloaded : Ts... { using Ts::operator()...; };
 template <class... Ts> overloaded(Ts...) -> overloaded<Ts...>;
 // clang-format on
 
-std::ifstream fin;
+namespace {
 
-auto FileHeader::open(const char *file) noexcept -> bool {
-  if(fin.is_open()) fin.close();
+// Copy a T out of the image, memcpy keeps unaligned offsets well defined. Bytes past the end of the image read as 0
+template <class T>
+auto readAt(std::span<const Elf_byte> image, const std::size_t offset, const std::size_t size = sizeof(T)) noexcept
+    -> T {
+  T value{};
+  if(offset < image.size())
+    std::memcpy(&value, image.data() + offset, std::min({size, sizeof(T), image.size() - offset}));
+  return value;
+}
+
+// Multi-byte fields of the ELF structures, as {offset, size}. Single bytes and byte arrays need no swapping
+struct Field {
+  std::size_t offset;
+  std::size_t size;
+};
+
+template <typename T>
+struct Layout;
+
+template <std::integral T>
+struct Layout<T> {
+  static constexpr std::array fields{Field{0, sizeof(T)}};
+};
+
+// clang-format off
+template <>
+struct Layout<Elf32_Header_t> {
+  using T = Elf32_Header_t;
+  static constexpr std::array fields{
+      Field{offsetof(T, type),        sizeof(T::type)},        Field{offsetof(T, machine),       sizeof(T::machine)},
+      Field{offsetof(T, version),     sizeof(T::version)},     Field{offsetof(T, entryPoint),    sizeof(T::entryPoint)},
+      Field{offsetof(T, phOffset),    sizeof(T::phOffset)},    Field{offsetof(T, shOffset),      sizeof(T::shOffset)},
+      Field{offsetof(T, flags),       sizeof(T::flags)},       Field{offsetof(T, size),          sizeof(T::size)},
+      Field{offsetof(T, phEntrySize), sizeof(T::phEntrySize)}, Field{offsetof(T, phNumber),      sizeof(T::phNumber)},
+      Field{offsetof(T, shEntrySize), sizeof(T::shEntrySize)}, Field{offsetof(T, shNumber),      sizeof(T::shNumber)},
+      Field{offsetof(T, shStringIndex), sizeof(T::shStringIndex)}};
+};
+
+template <>
+struct Layout<Elf64_Header_t> {
+  using T = Elf64_Header_t;
+  static constexpr std::array fields{
+      Field{offsetof(T, type),        sizeof(T::type)},        Field{offsetof(T, machine),       sizeof(T::machine)},
+      Field{offsetof(T, version),     sizeof(T::version)},     Field{offsetof(T, entryPoint),    sizeof(T::entryPoint)},
+      Field{offsetof(T, phOffset),    sizeof(T::phOffset)},    Field{offsetof(T, shOffset),      sizeof(T::shOffset)},
+      Field{offsetof(T, flags),       sizeof(T::flags)},       Field{offsetof(T, size),          sizeof(T::size)},
+      Field{offsetof(T, phEntrySize), sizeof(T::phEntrySize)}, Field{offsetof(T, phNumber),      sizeof(T::phNumber)},
+      Field{offsetof(T, shEntrySize), sizeof(T::shEntrySize)}, Field{offsetof(T, shNumber),      sizeof(T::shNumber)},
+      Field{offsetof(T, shStringIndex), sizeof(T::shStringIndex)}};
+};
+
+template <typename T> // Elf32_Program_Header_t and Elf64_Program_Header_t, whose field order differ
+  requires std::is_same_v<T, Elf32_Program_Header_t> || std::is_same_v<T, Elf64_Program_Header_t>
+struct Layout<T> {
+  static constexpr std::array fields{
+      Field{offsetof(T, type),   sizeof(T::type)},   Field{offsetof(T, flags),  sizeof(T::flags)},
+      Field{offsetof(T, offset), sizeof(T::offset)}, Field{offsetof(T, vaddr),  sizeof(T::vaddr)},
+      Field{offsetof(T, paddr),  sizeof(T::paddr)},  Field{offsetof(T, filesz), sizeof(T::filesz)},
+      Field{offsetof(T, memsz),  sizeof(T::memsz)},  Field{offsetof(T, align),  sizeof(T::align)}};
+};
+
+template <typename T>
+  requires std::is_same_v<T, Elf32_Section_Header_t> || std::is_same_v<T, Elf64_Section_Header_t>
+struct Layout<T> {
+  static constexpr std::array fields{
+      Field{offsetof(T, name),      sizeof(T::name)},      Field{offsetof(T, type),    sizeof(T::type)},
+      Field{offsetof(T, flags),     sizeof(T::flags)},     Field{offsetof(T, addr),    sizeof(T::addr)},
+      Field{offsetof(T, offset),    sizeof(T::offset)},    Field{offsetof(T, size),    sizeof(T::size)},
+      Field{offsetof(T, link),      sizeof(T::link)},      Field{offsetof(T, info),    sizeof(T::info)},
+      Field{offsetof(T, addralign), sizeof(T::addralign)}, Field{offsetof(T, entsize), sizeof(T::entsize)}};
+};
+
+template <typename T>
+  requires std::is_same_v<T, Elf32_Symbol_t> || std::is_same_v<T, Elf64_Symbol_t>
+struct Layout<T> {
+  static constexpr std::array fields{
+      Field{offsetof(T, name),  sizeof(T::name)},  Field{offsetof(T, value), sizeof(T::value)},
+      Field{offsetof(T, size),  sizeof(T::size)},  Field{offsetof(T, shndx), sizeof(T::shndx)}};
+};
+
+template <typename T>
+  requires std::is_same_v<T, Elf32_Rel_t> || std::is_same_v<T, Elf64_Rel_t>
+struct Layout<T> {
+  static constexpr std::array fields{Field{offsetof(T, offset), sizeof(T::offset)}, Field{offsetof(T, info), sizeof(T::info)}};
+};
+
+template <typename T>
+  requires std::is_same_v<T, Elf32_Rela_t> || std::is_same_v<T, Elf64_Rela_t>
+struct Layout<T> {
+  static constexpr std::array fields{Field{offsetof(T, offset), sizeof(T::offset)}, Field{offsetof(T, info), sizeof(T::info)},
+                                     Field{offsetof(T, addend), sizeof(T::addend)}};
+};
+
+template <typename T>
+  requires std::is_same_v<T, Elf32_Dynamic_t> || std::is_same_v<T, Elf64_Dynamic_t>
+struct Layout<T> {
+  static constexpr std::array fields{Field{offsetof(T, d_tag), sizeof(T::d_tag)}, Field{offsetof(T, d_un), sizeof(T::d_un)}};
+};
+
+template <typename T>
+  requires std::is_same_v<T, Elf32_Note_header_t> || std::is_same_v<T, Elf64_Note_header_t>
+struct Layout<T> {
+  static constexpr std::array fields{Field{offsetof(T, name_sz), sizeof(T::name_sz)}, Field{offsetof(T, desc_sz), sizeof(T::desc_sz)},
+                                     Field{offsetof(T, type), sizeof(T::type)}};
+};
+// clang-format on
+
+// Swapping the byte order of a T is a fixed permutation of its bytes: byte i of the result is byte permutation[i]
+template <typename T>
+constexpr auto swap_permutation = [] {
+  std::array<std::uint8_t, sizeof(T)> permutation{};
+  for(std::size_t i = 0; i != sizeof(T); ++i)
+    permutation[i] = static_cast<std::uint8_t>(i);
+
+  for(const auto [offset, size] : Layout<T>::fields)
+    for(std::size_t i = 0; i != size; ++i)
+      permutation[offset + i] = static_cast<std::uint8_t>(offset + size - 1 - i);
+
+  return permutation;
+}();
+
+template <typename T>
+auto byteswapped(const T &value) noexcept -> T {
+  constexpr auto &permutation = swap_permutation<T>;
+
+  const auto bytes = std::bit_cast<std::array<Elf_byte, sizeof(T)>>(value);
+  std::array<Elf_byte, sizeof(T)> swapped;
+  for(std::size_t i = 0; i != sizeof(T); ++i)
+    swapped[i] = bytes[permutation[i]];
+  return std::bit_cast<T>(swapped);
+}
+
+// readAt() for files whose byte order is not the host's when foreign is set
+template <class T>
+auto readAt(std::span<const Elf_byte> image, const std::size_t offset, const std::size_t size, const bool foreign) noexcept
+    -> T {
+  const auto value = readAt<T>(image, offset, size);
+  return foreign ? byteswapped(value) : value;
+}
 
-  fin.open(file, std::ios::binary);
+// Copy of a whole table with the first sizeof(T) bytes of every entry byte-swapped, the rest copied as is. The inner
+// loop applies the same constant permutation to each entry, a pattern compilers turn into vector shuffles, instead
+// of swapping fields one by one on every access. Empty if the entries are smaller than T, such a table is malformed
+template <typename T>
+auto byteswappedTable(std::span<const Elf_byte> table, const std::size_t entsize) -> std::vector<Elf_byte> {
+  constexpr auto &permutation = swap_permutation<T>;
+
+  if(entsize < sizeof(T)) return {};
+  std::vector<Elf_byte> swapped(table.begin(), table.end());
+
+  const auto n_entry = table.size() / entsize;
+  const Elf_byte *from = table.data();
+  Elf_byte *to = swapped.data();
+  for(std::size_t e = 0; e != n_entry; ++e, from += entsize, to += entsize)
+    for(std::size_t i = 0; i != sizeof(T); ++i)
+      to[i] = from[permutation[i]];
+
+  return swapped;
+}
+
+// Bytes [offset, offset + size) of the image as characters, clipped to the image
+auto tableAt(std::span<const Elf_byte> image, const std::size_t offset, const std::size_t size) noexcept
+    -> std::string_view {
+  if(offset >= image.size()) return {};
+  return {reinterpret_cast<const char *>(image.data() + offset), std::min(size, image.size() - offset)};
+}
 
+// Bytes [offset, offset + size) of the image, clipped to the image
+auto bytesAt(std::span<const Elf_byte> image, const std::size_t offset, const std::size_t size) noexcept
+    -> std::span<const Elf_byte> {
+  if(offset >= image.size()) return {};
+  return image.subspan(offset, std::min(size, image.size() - offset));
+}
+
+// Contents of a section, empty for SHT_NOBITS sections which occupy no file space
+template <typename Section>
+auto sectionBytes(std::span<const Elf_byte> image, const Section &section) noexcept -> std::span<const Elf_byte> {
+  if(section.type == 8 || section.offset >= image.size()) return {};
+  return image.subspan(section.offset, std::min<std::size_t>(section.size, image.size() - section.offset));
+}
+
+// '\0'-terminated string starting at offset inside a string table
+auto stringAt(std::string_view table, const std::size_t offset) noexcept -> std::string_view {
+  if(offset >= table.size()) return {};
+
+  table.remove_prefix(offset);
+  return table.substr(0, table.find('\0'));
+}
+
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept :
+    base{std::exchange(other.base, nullptr)},
+    length{std::exchange(other.length, 0)},
+    is_mapped{std::exchange(other.is_mapped, false)} {}
+
+auto MappedFile::operator=(MappedFile &&other) noexcept -> MappedFile & {
+  if(this != &other) {
+    close();
+    base = std::exchange(other.base, nullptr);
+    length = std::exchange(other.length, 0);
+    is_mapped = std::exchange(other.is_mapped, false);
+  }
+  return *this;
+}
+
+MappedFile::~MappedFile() {
+  close();
+}
+
+auto MappedFile::open(const char *file) noexcept -> bool {
+  close();
+
+#if defined(_WIN32)
+  std::ifstream fin(file, std::ios::binary | std::ios::ate);
   if(!fin.good()) return false;
 
+  const auto size = static_cast<std::size_t>(fin.tellg());
+  auto *buffer = new(std::nothrow) Elf_byte[size];
+  if(buffer == nullptr) return false;
+
+  fin.seekg(0);
+  if(!fin.read(reinterpret_cast<char *>(buffer), static_cast<std::streamsize>(size))) {
+    delete[] buffer;
+    return false;
+  }
+
+  base = buffer;
+  length = size;
+  return true;
+#else
+  const int fd = ::open(file, O_RDONLY | O_CLOEXEC);
+  if(fd == -1) return false;
+
+  struct stat st {};
+  if(::fstat(fd, &st) == -1 || st.st_size <= 0) {
+    ::close(fd);
+    return false;
+  }
+
+  const auto size = static_cast<std::size_t>(st.st_size);
+
+  if(void *p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0); p != MAP_FAILED) {
+    base = static_cast<const Elf_byte *>(p);
+    length = size;
+    is_mapped = true;
+    ::close(fd); // the mapping keeps its own reference to the file
+    return true;
+  }
+
+  // mmap is not supported on every file system, fall back to a single buffer
+  auto *buffer = new(std::nothrow) Elf_byte[size];
+  if(buffer == nullptr) {
+    ::close(fd);
+    return false;
+  }
+
+  for(std::size_t done = 0; done != size;) {
+    const auto n = ::pread(fd, buffer + done, size - done, static_cast<off_t>(done));
+    if(n <= 0) {
+      delete[] buffer;
+      ::close(fd);
+      return false;
+    }
+    done += static_cast<std::size_t>(n);
+  }
+
+  ::close(fd);
+  base = buffer;
+  length = size;
+  return true;
+#endif
+}
+
+void MappedFile::close() noexcept {
+  if(base == nullptr) return;
+
+#if !defined(_WIN32)
+  if(is_mapped) ::munmap(const_cast<Elf_byte *>(base), length);
+  else delete[] base;
+#else
+  delete[] base;
+#endif
+
+  base = nullptr;
+  length = 0;
+  is_mapped = false;
+}
+
+auto MappedFile::bytes() const noexcept -> std::span<const Elf_byte> {
+  return {base, length};
+}
+
+namespace {
+// Bytes at given offsets of a file, read with pread where there is one
+class FileReader {
+#if defined(_WIN32)
+  std::ifstream in;
+#else
+  int fd = -1;
+#endif
+
+public:
+  explicit FileReader(const char *file) noexcept {
+#if defined(_WIN32)
+    in.open(file, std::ios::binary);
+#else
+    fd = ::open(file, O_RDONLY | O_CLOEXEC);
+#endif
+  }
+
+  FileReader(const FileReader &) = delete;
+  auto operator=(const FileReader &) -> FileReader & = delete;
+
+  ~FileReader() {
+#if !defined(_WIN32)
+    if(fd != -1) ::close(fd);
+#endif
+  }
+
+  explicit operator bool() const noexcept {
+#if defined(_WIN32)
+    return in.good();
+#else
+    return fd != -1;
+#endif
+  }
+
+  // Fills buffer from offset on, fewer bytes at the end of the file. The number of bytes read
+  auto read(std::span<Elf_byte> buffer, const std::size_t offset) noexcept -> std::size_t {
+#if defined(_WIN32)
+    in.clear();
+    in.seekg(static_cast<std::streamoff>(offset));
+    in.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    return static_cast<std::size_t>(in.gcount());
+#else
+    std::size_t done = 0;
+    while(done != buffer.size()) {
+      const auto n = ::pread(fd, buffer.data() + done, buffer.size() - done, static_cast<off_t>(offset + done));
+      if(n <= 0) break;
+      done += static_cast<std::size_t>(n);
+    }
+    return done;
+#endif
+  }
+};
+
+constexpr std::size_t page_size = 4096;
+
+// Where the section header table of a probed file is, an empty one if it has none or it can't be read a page at a time
+struct Section_Table {
+  std::size_t offset = 0;
+  std::size_t entry_size = 0;
+  std::size_t count = 0;
+  bool is_64bit = false;
+  bool foreign = false;
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t {
+    return count * entry_size;
+  }
+};
+
+template <typename Header, typename Program_Header, typename Section_Header>
+void probeHeaders(std::span<const Elf_byte> page, const bool foreign, Probe_t &probe, Section_Table &table) noexcept {
+  const auto header = readAt<Header>(page, 0, sizeof(Header), foreign);
+  probe.type = getFileType(header.type);
+  probe.machine = getMachine(header.machine);
+
+  // Program headers follow the ELF header in practice, ones past the first page read as zeros and are ignored
+  bool has_interpreter = false;
+  for(std::size_t i = 0; header.phOffset != 0 && i != header.phNumber; ++i) {
+    const auto offset = header.phOffset + i * header.phEntrySize;
+    has_interpreter |= readAt<Program_Header>(page, offset, header.phEntrySize, foreign).type == 3; // PT_INTERP
+  }
+  probe.pie = header.type == 3 && has_interpreter;
+
+  // Stripped until a symbol table turns up in the section header table
+  probe.stripped = true;
+  table = {.is_64bit = sizeof(Header) == sizeof(Elf64_Header_t), .foreign = foreign};
+  if(header.shOffset == 0 || header.shEntrySize < sizeof(Section_Header) || header.shEntrySize > page_size) return;
+  table.offset = header.shOffset;
+  table.entry_size = header.shEntrySize;
+  table.count = header.shNumber;
+}
+
+// Decodes the first page of a file, nullopt if it isn't ELF. Where its section header table is goes to table
+auto probePage(std::span<const Elf_byte> page, Section_Table &table) noexcept -> std::optional<Probe_t> {
+  constexpr std::array<Elf_byte, 4> identification_bytes{0x7f, 'E', 'L', 'F'};
+  if(page.size() < i_nident || !std::ranges::equal(page.first(4), identification_bytes)) return std::nullopt;
+  if(page[i_class] != 1 && page[i_class] != 2) return std::nullopt;
+  if(page[i_data] != 1 && page[i_data] != 2) return std::nullopt;
+
+  Probe_t probe{.file_class = getFileClass(page[i_class]),
+                .data_encoding = getDataEncoding(page[i_data]),
+                .os_abi = getOSABI(page[i_osabi]),
+                .big_endian = page[i_data] == 2};
+  const bool foreign = probe.big_endian != (std::endian::native == std::endian::big);
+
+  if(page[i_class] == 2)
+    probeHeaders<Elf64_Header_t, Elf64_Program_Header_t, Elf64_Section_Header_t>(page, foreign, probe, table);
+  else probeHeaders<Elf32_Header_t, Elf32_Program_Header_t, Elf32_Section_Header_t>(page, foreign, probe, table);
+  return probe;
+}
+
+// Clears probe.stripped if one of the whole section headers in entries is a symbol table
+void probeSections(std::span<const Elf_byte> entries, const Section_Table &table, Probe_t &probe) noexcept {
+  for(std::size_t i = 0; i != entries.size() / table.entry_size; ++i) {
+    const auto offset = i * table.entry_size;
+    const auto type = table.is_64bit
+                          ? readAt<Elf64_Section_Header_t>(entries, offset, table.entry_size, table.foreign).type
+                          : readAt<Elf32_Section_Header_t>(entries, offset, table.entry_size, table.foreign).type;
+    if(type == 2) probe.stripped = false; // SHT_SYMTAB
+  }
+}
+} // namespace
+
+auto probe(const char *file) noexcept -> std::optional<Probe_t> {
+  FileReader reader{file};
+  if(!reader) return std::nullopt;
+
+  std::array<Elf_byte, page_size> buffer;
+  Section_Table table;
+  auto probe = probePage({buffer.data(), reader.read(buffer, 0)}, table);
+  if(!probe) return std::nullopt;
+
+  // Only the section types matter, the table is read a page at a time
+  const std::size_t per_page = page_size / std::max<std::size_t>(table.entry_size, 1);
+  for(std::size_t first = 0; first < table.count && probe->stripped; first += per_page) {
+    const auto size = std::min(per_page, table.count - first) * table.entry_size;
+    const auto n = reader.read({buffer.data(), size}, table.offset + first * table.entry_size);
+    probeSections({buffer.data(), n}, table, *probe);
+    if(n != size) break;
+  }
+  return probe;
+}
+
+auto probe(std::span<const Elf_byte> image) noexcept -> std::optional<Probe_t> {
+  Section_Table table;
+  auto probe = probePage(image, table);
+  if(!probe) return std::nullopt;
+
+  if(table.offset < image.size())
+    probeSections(image.subspan(table.offset, std::min(table.size(), image.size() - table.offset)), table, *probe);
+  return probe;
+}
+
+auto probeAll(std::span<const std::string> files) -> std::vector<std::optional<Probe_t>> {
+  std::vector<std::optional<Probe_t>> probes(files.size());
+
+#if !defined(_WIN32)
+  constexpr std::size_t window = 256;                 // files open at once
+  constexpr std::size_t table_limit = 16 * page_size; // larger section tables are left to probe()
+
+  detail::Ring ring{window};
+  if(ring.valid()) {
+    std::vector<int> fds(window);
+    std::vector<Section_Table> tables(window);
+    std::vector<Elf_byte> pages(window * page_size);
+    std::vector<Elf_byte> sections;
+    std::vector<detail::Ring::Read> reads;
+    std::vector<std::size_t> left; // files with section tables over the limit
+
+    for(std::size_t first = 0; first < files.size(); first += window) {
+      const auto count = std::min(window, files.size() - first);
+
+      // Opens are synchronous, only the reads go through the ring
+      reads.clear();
+      for(std::size_t i = 0; i != count; ++i) {
+        fds[i] = ::open(files[first + i].c_str(), O_RDONLY | O_CLOEXEC);
+        if(fds[i] != -1)
+          reads.push_back({.fd = fds[i], .buffer = {pages.data() + i * page_size, page_size}, .offset = 0, .index = i});
+      }
+      ring.run(reads);
+
+      std::size_t total = 0;
+      for(const auto &read : reads) {
+        if(read.result < 0) continue;
+        auto &probe = probes[first + read.index];
+        probe = probePage(read.buffer.first(static_cast<std::size_t>(read.result)), tables[read.index]);
+        if(!probe) continue;
+        if(tables[read.index].size() > table_limit) left.push_back(first + read.index);
+        else total += tables[read.index].size();
+      }
+
+      // Then every section header table in one piece
+      sections.resize(total);
+      std::size_t at = 0;
+      std::erase_if(reads, [&](detail::Ring::Read &read) {
+        const auto &table = tables[read.index];
+        if(!probes[first + read.index] || table.size() == 0 || table.size() > table_limit) return true;
+        read.buffer = {sections.data() + at, table.size()};
+        read.offset = table.offset;
+        at += table.size();
+        return false;
+      });
+      ring.run(reads);
+
+      for(const auto &read : reads)
+        if(read.result > 0)
+          probeSections(read.buffer.first(static_cast<std::size_t>(read.result)), tables[read.index],
+                        *probes[first + read.index]);
+
+      for(std::size_t i = 0; i != count; ++i)
+        if(fds[i] != -1) ::close(fds[i]);
+    }
+
+    for(const auto i : left) probes[i] = probe(files[i].c_str());
+    return probes;
+  }
+#endif
+
+  for(std::size_t i = 0; i != files.size(); ++i) probes[i] = probe(files[i].c_str());
+  return probes;
+}
+
+auto FileHeader::open(const char *file) noexcept -> bool {
+  MappedFile mapped;
+  if(!mapped.open(file)) {
+    (void)open(std::span<const Elf_byte>{}); // forget the previous file
+    return false;
+  }
+
+  const bool elf = open(mapped.bytes());
+  this->file = std::move(mapped); // the mapping moves along with its owner, image_view stays valid
+  return elf;
+}
+
+auto FileHeader::open(std::span<const Elf_byte> image) noexcept -> bool {
+  program_headers.clear();
+  section_headers.clear();
+  section_index.clear();
+  loads.clear();
+  shstrtab_view = strtab_view = dynstr_view = {};
+  swapped_tables.clear();
+  foreign_byte_order = false;
+
+  file.close();
+  image_view = image;
+
   if(!isELF()) return false;
 
   if(is64bit()) elf_header = Elf64_Header_t{};
@@ -40,83 +591,115 @@ auto FileHeader::open(const char *file) noexcept -> bool {
 }
 
 void FileHeader::decode() noexcept {
-  fin.seekg(0);
+  const auto image = bytes();
+
+  // every multi-byte field is swapped on the way in when the file's byte order is not the host's
+  const bool big_endian = readAt<Elf_byte>(image, i_data) == 2;
+  foreign_byte_order = big_endian != (std::endian::native == std::endian::big);
+  const bool foreign = foreign_byte_order;
+
   // clang-format off
   std::visit(
     overloaded{
       [&](Elf32_Header_t &elf_header) {
-            fin.read(reinterpret_cast<char *>(&elf_header), sizeof(Elf32_Header_t)); // read ELF header
+            elf_header = readAt<Elf32_Header_t>(image, 0, sizeof(Elf32_Header_t), foreign); // read ELF header
 
             if(const auto shOffset = elf_header.shOffset; shOffset != 0) {
-              fin.seekg(shOffset + (elf_header.shStringIndex * elf_header.shEntrySize)); // seek to shstrtab section to get section names
-
-              Elf32_Section_Header_t shstrtab;
-              fin.read(reinterpret_cast<char *>(&shstrtab), elf_header.shEntrySize);
-
-              fin.seekg(shOffset); // seek back to section offset and get sections to map as, [name] -> section
-
-              for(std::size_t i = 0; i != elf_header.shNumber; ++i) {
-                Elf32_Section_Header_t section;
-                fin.read(reinterpret_cast<char *>(&section), elf_header.shEntrySize); // read section
-
-                auto position_before_reading_section_name = fin.tellg(); // push read pointer to a variable
-
-                fin.seekg(shstrtab.offset + section.name); // seek section name
-                std::string sectionName;
-                std::getline(fin, sectionName, '\0');
-
-                section_headers[sectionName] = section;
-                fin.seekg(position_before_reading_section_name); // pop read pointer back
+              // shstrtab section to get section names
+              const auto shstrtab = readAt<Elf32_Section_Header_t>(image, shOffset + (elf_header.shStringIndex * elf_header.shEntrySize), elf_header.shEntrySize, foreign);
+              shstrtab_view = tableAt(image, shstrtab.offset, shstrtab.size);
+
+              section_headers.reserve(elf_header.shNumber);
+              for(std::size_t i = 0; i != elf_header.shNumber; ++i) { // sections in table order, names are indexed below
+                const auto section = readAt<Elf32_Section_Header_t>(image, shOffset + i * elf_header.shEntrySize, elf_header.shEntrySize, foreign);
+                section_headers.push_back({stringAt(shstrtab_view, section.name), section});
               }
             }
 
             if(auto phOffset = elf_header.phOffset; phOffset != 0) { // no program header if the offset is 0
               program_headers.resize(elf_header.phNumber, Elf32_Program_Header_t{});
 
-              fin.seekg(phOffset);
-
-              for(auto &ph : program_headers)
-                fin.read(reinterpret_cast<char *>(&ph), elf_header.phEntrySize);
+              for(std::size_t i = 0; auto &ph : program_headers)
+                ph = readAt<Elf32_Program_Header_t>(image, phOffset + i++ * elf_header.phEntrySize, elf_header.phEntrySize, foreign);
             }
 
       },
       [&](Elf64_Header_t &elf_header) {
-            fin.read(reinterpret_cast<char *>(&elf_header), sizeof(Elf64_Header_t));
+            elf_header = readAt<Elf64_Header_t>(image, 0, sizeof(Elf64_Header_t), foreign);
 
             if(const auto shOffset = elf_header.shOffset; shOffset != 0) {
-              fin.seekg(shOffset + (elf_header.shStringIndex * elf_header.shEntrySize));
-
-              Elf64_Section_Header_t shstrtab;
-              fin.read(reinterpret_cast<char *>(&shstrtab), elf_header.shEntrySize);
-
-              fin.seekg(shOffset);
+              const auto shstrtab = readAt<Elf64_Section_Header_t>(image, shOffset + (elf_header.shStringIndex * elf_header.shEntrySize), elf_header.shEntrySize, foreign);
+              shstrtab_view = tableAt(image, shstrtab.offset, shstrtab.size);
 
+              section_headers.reserve(elf_header.shNumber);
               for(std::size_t i = 0; i != elf_header.shNumber; ++i) {
-                Elf64_Section_Header_t section;
-                fin.read(reinterpret_cast<char *>(&section), elf_header.shEntrySize);
-
-                auto position_before_reading_section_name = fin.tellg();
-
-                fin.seekg(shstrtab.offset + section.name);
-                std::string sectionName;
-                std::getline(fin, sectionName, '\0');
-
-                section_headers[sectionName] = section;
-                fin.seekg(position_before_reading_section_name);
+                const auto section = readAt<Elf64_Section_Header_t>(image, shOffset + i * elf_header.shEntrySize, elf_header.shEntrySize, foreign);
+                section_headers.push_back({stringAt(shstrtab_view, section.name), section});
               }
             }
 
             if(auto phOffset = elf_header.phOffset; phOffset != 0) {
               program_headers.resize(elf_header.phNumber, Elf64_Program_Header_t{});
 
-              fin.seekg(phOffset);
-
-              for(auto &ph : program_headers)
-                fin.read(reinterpret_cast<char *>(&ph), elf_header.phEntrySize);
+              for(std::size_t i = 0; auto &ph : program_headers)
+                ph = readAt<Elf64_Program_Header_t>(image, phOffset + i++ * elf_header.phEntrySize, elf_header.phEntrySize, foreign);
             }
       }
     }, elf_header);
   // clang-format on
+
+  if(foreign) swapTables();
+
+  for(const auto &ph : program_headers) {
+    std::visit(
+        [this](const auto &x) {
+          if(x.type == 1) loads.push_back({x.vaddr, x.offset, x.filesz}); // PT_LOAD
+        },
+        ph);
+  }
+  std::ranges::sort(loads, {}, &Load::vaddr); // already in order in well formed files
+
+  section_index.reserve(section_headers.size());
+  for(std::size_t i = 0; i != section_headers.size(); ++i)
+    section_index.try_emplace(section_headers[i].name, i); // first one wins when a name repeats, e.g. .text in .o files
+
+  const auto string_table = [&](std::string_view name) -> std::string_view {
+    const auto *section = findSection(name);
+    if(section == nullptr) return {};
+
+    return std::visit([&](const auto &sh) { return tableAt(image, sh.offset, sh.size); }, section->header);
+  };
+
+  strtab_view = string_table(".strtab");
+  dynstr_view = string_table(".dynstr");
+}
+
+auto FileHeader::vaddrToOffset(const std::size_t vaddr) const noexcept -> std::optional<std::size_t> {
+  auto load = std::ranges::upper_bound(loads, vaddr, {}, &Load::vaddr);
+  if(load == loads.begin()) return std::nullopt;
+  --load;
+
+  if(vaddr - load->vaddr >= load->filesz) return std::nullopt;
+  return load->offset + (vaddr - load->vaddr);
+}
+
+auto FileHeader::readAtVirtualAddress(const std::size_t vaddr, const std::size_t length) const noexcept
+    -> std::span<const Elf_byte> {
+  auto load = std::ranges::upper_bound(loads, vaddr, {}, &Load::vaddr);
+  if(load == loads.begin()) return {};
+  --load;
+
+  const auto into = vaddr - load->vaddr;
+  if(into >= load->filesz || length > load->filesz - into) return {};
+
+  const auto image = bytes();
+  const auto offset = load->offset + into;
+  if(offset > image.size() || length > image.size() - offset) return {};
+  return image.subspan(offset, length);
+}
+
+auto FileHeader::bytes() const noexcept -> std::span<const Elf_byte> {
+  return image_view;
 }
 
 auto FileHeader::identificationArray() const noexcept -> std::span<const Elf_byte> {
@@ -126,26 +709,15 @@ auto FileHeader::identificationArray() const noexcept -> std::span<const Elf_byt
 }
 
 auto FileHeader::fileClass() const noexcept -> std::string_view {
-  auto classData = std::visit(overloaded{[](const Elf32_Header_t &x32) { return x32.ident[i_class]; },
-                                         [](const Elf64_Header_t &x64) { return x64.ident[i_class]; }},
-                              elf_header);
-  switch(classData) {
-  case 0: return "None";  // Invalid class
-  case 1: return "ELF32"; // 32-bit objects, machines with virtual address spaces up to 4Gb
-  case 2: return "ELF64"; // 64-bit objects
-  }
+  return getFileClass(std::visit(overloaded{[](const Elf32_Header_t &x32) { return x32.ident[i_class]; },
+                                            [](const Elf64_Header_t &x64) { return x64.ident[i_class]; }},
+                                 elf_header));
 }
 
 auto FileHeader::fileDataEncoding() const noexcept -> std::string_view {
-  auto encodingData = std::visit(overloaded{[](const Elf32_Header_t &x32) { return x32.ident[i_data]; },
-                                            [](const Elf64_Header_t &x64) { return x64.ident[i_data]; }},
-                                 elf_header);
-
-  switch(encodingData) {
-  case 0: return "None";
-  case 1: return "2's complement, little endian"; // 0x0102 -> 0x02 0x01
-  case 2: return "2's complement, big endian";    // 0x0102 -> 0x01 0x02
-  }
+  return getDataEncoding(std::visit(overloaded{[](const Elf32_Header_t &x32) { return x32.ident[i_data]; },
+                                               [](const Elf64_Header_t &x64) { return x64.ident[i_data]; }},
+                                    elf_header));
 }
 
 auto FileHeader::fileVersion() const noexcept -> std::string_view {
@@ -157,29 +729,13 @@ auto FileHeader::fileVersion() const noexcept -> std::string_view {
   case 0: return "0 (Invalid)";
   case 1: return "1 (Current)";
   }
+  return "Unknown";
 }
 
 auto FileHeader::osABI() const noexcept -> std::string_view {
-  auto osABI = std::visit(overloaded{[](const Elf32_Header_t &x32) { return x32.ident[i_osabi]; },
-                                     [](const Elf64_Header_t &x64) { return x64.ident[i_osabi]; }},
-                          elf_header);
-  switch(osABI) {
-  case 0: return "UNIX System V ABI";
-  case 1: return "HP-UX";
-  case 2: return "NetBSD";
-  case 3: return "Object uses GNU ELF extensions";
-  // case osabi::linux: return "Compatibility alias";
-  case 6: return "Sun Solaris";
-  case 7: return "IBM AIX";
-  case 8: return "SGI Irix";
-  case 9: return "FreeBSD";
-  case 10: return "Compaq TRU64 UNIX";
-  case 11: return "Novell Modesto";
-  case 12: return "OpenBSD";
-  case 64: return "ARM EABI";
-  case 97: return "ARM";
-  case 255: return "Standalone (embedded) application";
-  }
+  return getOSABI(std::visit(overloaded{[](const Elf32_Header_t &x32) { return x32.ident[i_osabi]; },
+                                        [](const Elf64_Header_t &x64) { return x64.ident[i_osabi]; }},
+                             elf_header));
 }
 
 auto FileHeader::ABIVersion() const noexcept -> int {
@@ -189,48 +745,15 @@ auto FileHeader::ABIVersion() const noexcept -> int {
 }
 
 auto FileHeader::type() const noexcept -> std::string_view {
-  auto fileType = std::visit(overloaded{[](const Elf32_Header_t &x32) { return x32.type; },
-                                        [](const Elf64_Header_t &x64) { return x64.type; }},
-                             elf_header);
-  switch(fileType) {
-  case 0: return "No file type";
-  case 1: return "Relocatible file";
-  case 2: return "Executable file";
-  case 3: return "Shared object file";
-  case 4: return "Core file";
-  }
-
-  if(fileType >= 0xff00 && fileType <= 0xffff) {
-    return "Processor specific";
-  }
+  return getFileType(std::visit(overloaded{[](const Elf32_Header_t &x32) { return x32.type; },
+                                           [](const Elf64_Header_t &x64) { return x64.type; }},
+                                elf_header));
 }
 
 auto FileHeader::machine() const noexcept -> std::string_view {
-  auto machine = std::visit(overloaded{[](const Elf32_Header_t &x32) { return x32.machine; },
-                                       [](const Elf64_Header_t &x64) { return x64.machine; }},
-                            elf_header);
-  switch(machine) {
-  case 0: return "An unknown machine";
-  case 1: return "AT&T WE 32100";
-  case 2: return "Sun Microsystems SPARC";
-  case 3: return "Intel 80386";
-  case 4: return "Motorola 68000";
-  case 5: return "Motorola 88000";
-  case 7: return "Intel 80860";
-  case 8: return "MIPS RS3000 (big-endian only)";
-  case 15: return "HP/PA";
-  case 18: return "SPARC with enhanced instruction set";
-  case 20: return "PowerPC";
-  case 21: return "PowerPC 64-bit";
-  case 22: return "IBM S/390";
-  case 40: return "Advanced RISC Machines";
-  case 42: return "Renesas SuperH";
-  case 43: return "SPARC v9 64-bit";
-  case 50: return "Intel Itanium";
-  case 62: return "AMD x86-64";
-  case 75: return "DEC Vax";
-  case 183: return "AARCH64";
-  }
+  return getMachine(std::visit(overloaded{[](const Elf32_Header_t &x32) { return x32.machine; },
+                                          [](const Elf64_Header_t &x64) { return x64.machine; }},
+                               elf_header));
 }
 
 auto FileHeader::version() const noexcept -> std::size_t {
@@ -266,220 +789,321 @@ auto FileHeader::sectionHeaders() const noexcept -> const decltype(section_heade
   return section_headers;
 }
 
+auto FileHeader::findSection(std::string_view name) const noexcept -> const Section_t * {
+  if(const auto found = section_index.find(name); found != section_index.end())
+    return &section_headers[found->second];
+  return nullptr;
+}
+
 auto FileHeader::symbols() const noexcept -> const std::vector<Symbol_t> {
   std::vector<Symbol_t> symbols;
-
-  std::visit(
-         overloaded{
-           [&](const Elf32_Section_Header_t &x32) {
-                 fin.seekg(x32.offset);
-
-                 for(std::size_t i = 0; i != (x32.size / x32.entsize); ++i) {
-                   Elf32_Symbol_t symbol{};
-                   fin.read(reinterpret_cast<char *>(&symbol), sizeof(Elf32_Symbol_t));
-                   symbols.push_back(symbol);
-                 }
-           }, 
-           [&](const Elf64_Section_Header_t &x64) {
-                 fin.seekg(x64.offset);
-  
-                 for(std::size_t i = 0; i != (x64.size / x64.entsize); ++i) {
-                   Elf64_Symbol_t symbol{};
-                   fin.read(reinterpret_cast<char *>(&symbol), sizeof(Elf64_Symbol_t));
-                   symbols.push_back(symbol);
-                 }
-           }
-         }, section_headers.find(".symtab")->second);
-
+  std::visit([&](const auto &table) { symbols.assign(table.begin(), table.end()); }, symbolTable());
   return symbols;
 }
 
-
 auto FileHeader::dynamicSymbols() const noexcept -> const std::vector<Symbol_t> {
   std::vector<Symbol_t> dynSymbols;
-
-  if(section_headers.contains(".dynsym")) {
-    std::visit(
-           overloaded{
-             [&](const Elf32_Section_Header_t &x32) {
-                   fin.seekg(x32.offset);
-    
-                   for(int i = 0; i != (x32.size / x32.entsize); ++i) {
-                     Elf32_Symbol_t symbol{};
-                     fin.read(reinterpret_cast<char *>(&symbol), sizeof(decltype(symbol)));
-                     dynSymbols.push_back(symbol);
-                   }
-             }, 
-             [&](const Elf64_Section_Header_t &x64) {
-                   fin.seekg(x64.offset);
-    
-                   for(int i = 0; i != (x64.size / x64.entsize); ++i) {
-                     Elf64_Symbol_t symbol{};
-                     fin.read(reinterpret_cast<char *>(&symbol), sizeof(decltype(symbol)));
-                     dynSymbols.push_back(symbol);
-                   }
-             }
-           }, section_headers.find(".dynsym")->second);
-  }
-
+  std::visit([&](const auto &table) { dynSymbols.assign(table.begin(), table.end()); }, dynamicSymbolTable());
   return dynSymbols;
 }
 
-auto FileHeader::notes() const noexcept -> const std::map<std::string, std::tuple<std::string, std::size_t, std::string>> {
-  std::map<std::string, std::tuple<std::string, std::size_t, std::string>> things;
-
-  auto note_section_filter = [] (const auto &section) {
-    return section.first.starts_with(".note");
-  };
+auto FileHeader::symbolTable() const noexcept -> Symbol_Table_t {
+  return symbolTableOf(findSection(".symtab"));
+}
 
-  for(const auto &[name, section] : section_headers | std::ranges::views::filter(note_section_filter)) {
-    auto offset = std::visit(overloaded{[](const Elf32_Section_Header_t &x32) -> std::size_t { return x32.offset; },
-                                        [](const Elf64_Section_Header_t &x64) -> std::size_t { return x64.offset; }},
-                             section);
-    fin.seekg(offset);
-
-    Elf32_Note_header_t note;
-    fin.read(reinterpret_cast<char *>(&note), sizeof(decltype(note)));
-
-    std::string noteName;
-    std::getline(fin, noteName, '\0');
-
-    std::vector<Elf32_Word> desc_words(note.desc_sz / sizeof(Elf32_Word), Elf32_Word{});
-    for(auto &word : desc_words)
-      fin.read(reinterpret_cast<char *>(&word), sizeof(Elf32_Word));
-
-    // clang-format on
-    std::ostringstream sout;
-    if(note.type == 1) { // description words:
-      // word 0: OS descriptor
-      // word 1: major version of the ABI
-      // word 2: minor version of the ABI
-      // word 3: subminor version of the ABI
-
-      sout << "NT_GNU_ABI_TAG\n";
-      sout << "OS: ";
-
-      switch(desc_words[0]) {
-      case 0: sout << "Linux, "; break;
-      case 1: sout << "GNU, "; break;
-      case 2: sout << "Solaris2, "; break;
-      case 3: sout << "FreeBSD, "; break;
-      }
+auto FileHeader::dynamicSymbolTable() const noexcept -> Symbol_Table_t {
+  return symbolTableOf(findSection(".dynsym"));
+}
 
-      sout << "ABI: " << desc_words[1] << '.' << desc_words[2] << '.' << desc_words[3];
-      sout << '\n';
-    }
+auto FileHeader::findDynamicSymbol(std::string_view name) const noexcept -> std::optional<Symbol_t> {
+  return visit([&](const auto &elf) -> std::optional<Symbol_t> {
+    if(const auto symbol = elf.findDynamicSymbol(name)) return *symbol;
+    return std::nullopt;
+  });
+}
 
-    else if(note.type == 2) {
-      sout << "NT_GNU_HWCAP"; // Synthetic hwcap information.
-      // word 0: number of entries
-      // word 1: bitmask of enabled entries
-      // Then follow variable-length entries, one byte followed by a '\0'-terminated hwcap name string.
-      // The byte gives the bit number to test if enabled, (1U << bit) & bitmask.
-      std::vector<Elf_byte> entries(desc_words[0], Elf_byte{});
-      const auto bitmask = desc_words[1];
-      for(int i = 0; const auto entry : entries) {
-        [[maybe_unused]] auto _ = (1U << i) & bitmask; // REVISIT, implement this
-      }
-    }
+auto FileHeader::notes() const noexcept -> std::vector<NoteView> {
+  std::vector<NoteView> views;
 
-    else if(note.type == 3) {
-      sout << "NT_GNU_BUILD_ID\n";
-      sout << "Build ID: ";
-      for(auto word : desc_words)
-        sout << std::hex << word;
-      sout << '\n';
-    }
+  const auto image = bytes();
+  for(const auto &[name, section] : section_headers) {
+    std::visit(
+        [&](const auto &sh) {
+          if(sh.type != 7) return; // SHT_NOTE
+          NoteView view{sectionBytes(image, sh), sh.addralign, foreign_byte_order};
+          view.section_name = name;
+          view.section_offset = sh.offset;
+          views.push_back(view);
+        },
+        section);
+  }
+  if(!views.empty()) return views;
 
-    else if(note.type == 4) {
-      sout << "NT_GNU_GOLD_VERSION\n";
-    }
+  // The segments hold the same notes as the sections, they are only read when there are no sections to name them
+  for(const auto &ph : program_headers) {
+    std::visit(
+        [&](const auto &x) {
+          if(x.type != 4) return; // PT_NOTE
+          NoteView view{bytesAt(image, x.offset, x.filesz), x.align, foreign_byte_order};
+          view.section_offset = x.offset;
+          views.push_back(view);
+        },
+        ph);
+  }
+  return views;
+}
 
-    else if(note.type == 5) {
-      sout << "NT_GNU_PROPERTY_TYPE_0\n";
-    }
+namespace {
+// NT_GNU_BUILD_ID note among the notes of a segment or section
+auto buildIdIn(const NoteView &notes) noexcept -> std::span<const Elf_byte> {
+  for(const auto &note : notes)
+    if(note.type == 3 && note.name == "GNU") return note.desc;
+  return {};
+}
 
-    else {
-      sout << "Unknown note type: " << '(' << "0x" << std::hex << note.type << ')' << '\n';
-      for(auto word : desc_words)
-        sout << std::hex << word << ' ';
-      sout << '\n';
+// Straight from the image, the headers are read one by one and the segments are searched as soon as they are read
+template <typename Header, typename Program_Header, typename Section_Header>
+auto findBuildId(std::span<const Elf_byte> image, const bool foreign) noexcept -> std::span<const Elf_byte> {
+  const auto header = readAt<Header>(image, 0, sizeof(Header), foreign);
+
+  if(header.phOffset != 0) {
+    for(std::size_t i = 0; i != header.phNumber; ++i) {
+      const auto offset = header.phOffset + i * header.phEntrySize;
+      const auto ph = readAt<Program_Header>(image, offset, header.phEntrySize, foreign);
+      if(ph.type != 4) continue; // PT_NOTE
+      if(const auto id = buildIdIn({bytesAt(image, ph.offset, ph.filesz), ph.align, foreign}); !id.empty()) return id;
     }
-
-    things[name] = std::make_tuple(noteName, note.desc_sz, sout.str());
+    return {};
   }
 
-  return things;
+  // Relocatable objects have no program headers
+  for(std::size_t i = 0; header.shOffset != 0 && i != header.shNumber; ++i) {
+    const auto offset = header.shOffset + i * header.shEntrySize;
+    const auto sh = readAt<Section_Header>(image, offset, header.shEntrySize, foreign);
+    if(sh.type != 7) continue; // SHT_NOTE
+    if(const auto id = buildIdIn({sectionBytes(image, sh), sh.addralign, foreign}); !id.empty()) return id;
+  }
+  return {};
 }
+} // namespace
 
-auto FileHeader::relocations() const noexcept
-    -> const std::map<std::pair<std::string, std::size_t>,
-                      std::vector<std::tuple<std::size_t, std::size_t, std::string_view, std::size_t, std::string>>> {
+auto FileHeader::buildId() const noexcept -> std::span<const Elf_byte> {
+  const auto image = bytes();
+  if(image.size() <= i_data) return {};
 
-  // clang-format off
-  constexpr auto r_sym_32_sym  = [] (const std::size_t info) -> size_t { return info >> 8;         };
-  constexpr auto r_sym_32_type = [] (const std::size_t info) -> size_t { return info & 0xff;       };
-
-  constexpr auto r_sym_64_sym  = [] (const std::size_t info) -> size_t { return info >> 32;        };
-  constexpr auto r_sym_64_type = [] (const std::size_t info) -> size_t { return info & 0xffffffff; };
-  // clang-format on
+  const bool foreign = (image[i_data] == 2) != (std::endian::native == std::endian::big);
+  if(is64bit()) return findBuildId<Elf64_Header_t, Elf64_Program_Header_t, Elf64_Section_Header_t>(image, foreign);
+  return findBuildId<Elf32_Header_t, Elf32_Program_Header_t, Elf32_Section_Header_t>(image, foreign);
+}
 
-  std::map<std::pair<std::string, std::size_t>,
-           std::vector<std::tuple<std::size_t, std::size_t, std::string_view, std::size_t, std::string>>>
-      things;
+namespace {
+// Relocation type names depend on the machine only, not the class (x32 is ELF32 with x86-64 relocations), so the
+// table is picked once for the whole file. Types of other machines are "Unknown"
+template <typename Elf>
+auto relocationTypeNames(const Elf &elf) noexcept -> std::string_view (*)(unsigned int) {
+  switch(elf.header().machine) {
+  case 3: return i386_relocation_type;
+  case 62: return amd64_relocation_type;
+  case 183: return aarch64_relocation_type;
+  }
+  return unknown_relocation_type;
+}
+} // namespace
+
+auto FileHeader::relocations() const noexcept -> std::vector<Relocation_Section_t> {
+  std::vector<Relocation_Section_t> things;
+
+  visit([&]<typename Elf>(const Elf &elf) {
+    using Class = typename Elf::class_type;
+    using Section_Header = typename Elf::Section_Header;
+
+    const auto relocation_type = relocationTypeNames(elf);
+
+    // Value and name of every symbol of a table, resolved in one pass over it the first time a relocation section
+    // links to it. Object files have a relocation section per code section, all of them sharing .symtab
+    struct Resolved {
+      std::size_t value;
+      std::string_view name;
+    };
+    std::unordered_map<std::size_t, std::vector<Resolved>> resolved_tables;
+
+    const auto resolved = [&](const std::size_t link) -> const std::vector<Resolved> & {
+      auto [it, inserted] = resolved_tables.try_emplace(link);
+      if(!inserted) return it->second;
+
+      const auto *symtab = elf.section(link);
+      if(symtab == nullptr || (symtab->type != 2 && symtab->type != 11)) return it->second;
+
+      const auto strings = elf.linkedStrings(*symtab);
+      const auto symbols = elf.template table<typename Elf::Symbol>(*symtab);
+      it->second.reserve(symbols.size());
+
+      for(const auto symbol : symbols) {
+        std::string_view name;
+        if((symbol.info & 0xf) == 3) { // STT_SECTION symbols are named after their section
+          if(const auto *section = elf.section(symbol.shndx)) name = elf.sectionName(*section);
+        } else if(symbol.name < strings.size()) {
+          name = strings.substr(symbol.name);
+          name = name.substr(0, name.find('\0'));
+        }
+        it->second.push_back({symbol.value, name});
+      }
+      return it->second;
+    };
+
+    const auto join = [&](const auto &entries, const Section_Header &section) {
+      const auto &symbols = resolved(section.link);
+
+      auto &rel_section = things.emplace_back(Relocation_Section_t{
+          .name = elf.sectionName(section), .offset = section.offset, .has_addend = section.type == 4, .entries = {}});
+      rel_section.entries.reserve(entries.size());
+
+      for(const auto rel : entries) {
+        Relocation_t relocation{.offset = rel.offset,
+                                .info = rel.info,
+                                .type = relocation_type(static_cast<unsigned int>(Class::relocationType(rel.info))),
+                                .addend = 0,
+                                .symbol = Class::relocationSymbol(rel.info),
+                                .symbol_value = 0,
+                                .symbol_name = {}};
+
+        if constexpr(requires { rel.addend; }) relocation.addend = rel.addend;
+
+        if(relocation.symbol != 0 && relocation.symbol < symbols.size()) {
+          relocation.symbol_value = symbols[relocation.symbol].value;
+          relocation.symbol_name = symbols[relocation.symbol].name;
+        }
+        rel_section.entries.push_back(relocation);
+      }
+    };
 
-  auto relocation_section_filter = [](const auto &section) {
-    const auto &[sectionName, _] = section;
-    return sectionName.starts_with(".rel") || sectionName.starts_with(".rela");
-  };
+    for(const auto &[name, header] : section_headers) {
+      const auto &section = std::get<Section_Header>(header);
+      if(section.type == 4) join(elf.template table<typename Class::Rela>(section), section);
+      if(section.type == 9) join(elf.template table<typename Class::Rel>(section), section);
+    }
+  });
 
-  for(const auto &[sectionName, section] : section_headers | std::ranges::views::filter(relocation_section_filter)) {
-    if(fileClass() == "ELF32") {
-      const auto &rel_section = std::get<Elf32_Section_Header_t>(section);
+  return things;
+}
 
-      fin.seekg(rel_section.offset);
+auto FileHeader::relocationTables() const noexcept -> std::vector<RelocationView> {
+  std::vector<RelocationView> tables;
+
+  visit([&]<typename Elf>(const Elf &elf) {
+    using Class = typename Elf::class_type;
+    using Section_Header = typename Elf::Section_Header;
+
+    const auto type_name = relocationTypeNames(elf);
+
+    for(const auto &[name, header] : section_headers) {
+      const auto &section = std::get<Section_Header>(header);
+      if(section.type != 4 && section.type != 9) continue;
+
+      RelocationView &view = tables.emplace_back();
+      view.section_name = name;
+      view.section_offset = section.offset;
+      view.has_addend = section.type == 4;
+      view.table = elf.sectionData(section);
+      view.entsize = section.entsize;
+      view.count = view.has_addend ? elf.template table<typename Class::Rela>(section).size()
+                                   : elf.template table<typename Class::Rel>(section).size();
+      view.sections = section_headers;
+      view.type_name = type_name;
+      view.decoder = view.has_addend ? &RelocationView::decode<Class, typename Class::Rela>
+                                     : &RelocationView::decode<Class, typename Class::Rel>;
+
+      if(const auto *symtab = elf.section(section.link); symtab && (symtab->type == 2 || symtab->type == 11)) {
+        view.symbols = elf.sectionData(*symtab);
+        view.symbol_entsize = symtab->entsize;
+        view.strings = elf.linkedStrings(*symtab);
+      }
+    }
+  });
 
-      std::vector<std::tuple<std::size_t, std::size_t, std::string_view, std::size_t, std::string>> entries;
+  return tables;
+}
 
-      const auto n_entry = rel_section.size / rel_section.entsize;
-      for(int i = 0; i < n_entry; ++i) {
-        Elf32_Rel_t rel{};
-        fin.read(reinterpret_cast<char *>(&rel), sizeof(decltype(rel)));
+auto FileHeader::dynamic() const noexcept -> std::vector<Dynamic_t> {
+  std::vector<Dynamic_t> entries;
+
+  visit([&]<typename Elf>(const Elf &elf) {
+    using Class = typename Elf::class_type;
+    using Tag = decltype(Class::Dynamic::d_tag);
+    using Value = decltype(Class::Dynamic::d_un.d_val);
+
+    // Where the table is, and the string table its names are in
+    std::size_t offset = 0;
+    std::size_t size = 0;
+    std::string_view strings = dynstr_view;
+
+    if(const auto *section = elf.findSection(".dynamic"); section != nullptr && section->type == 6) {
+      offset = section->offset;
+      size = section->size;
+      if(const auto linked = elf.linkedStrings(*section); !linked.empty()) strings = linked;
+    } else {
+      for(const auto &ph : elf.programHeaders()) {
+        if(ph.type != 2) continue; // PT_DYNAMIC
+        offset = ph.offset;
+        size = ph.filesz;
+        break;
+      }
+    }
 
-        entries.push_back(std::make_tuple(rel.offset, rel.info, i386_relocation_type(r_sym_32_type(rel.info)),
-                                          0xabcdef0, "implement_this"));
+    // Without section headers the string table is found through DT_STRTAB, an address in one of the PT_LOAD segments
+    if(strings.empty()) {
+      std::size_t strtab = 0;
+      std::size_t strsz = 0;
+      const auto end = std::min(offset + size, elf.bytes().size());
+      for(auto at = offset; at + sizeof(typename Class::Dynamic) <= end; at += sizeof(typename Class::Dynamic)) {
+        const auto tag = elf.template read<Tag>(at);
+        if(tag == 0) break;
+        if(tag == 5) strtab = static_cast<std::size_t>(elf.template read<Value>(at + sizeof(Tag)));
+        if(tag == 10) strsz = static_cast<std::size_t>(elf.template read<Value>(at + sizeof(Tag)));
       }
 
-      things[std::make_pair(sectionName, rel_section.offset)] = std::move(entries);
+      if(const auto at = vaddrToOffset(strtab)) strings = tableAt(elf.bytes(), *at, strsz);
     }
 
-    else {
-      const auto &rel_section = std::get<Elf64_Section_Header_t>(section);
+    // One pass over the table as it is in the file, each field read in the file's byte order
+    const auto end = std::min(offset + size, elf.bytes().size());
+    for(; offset + sizeof(typename Class::Dynamic) <= end; offset += sizeof(typename Class::Dynamic)) {
+      const auto tag = static_cast<std::int64_t>(elf.template read<Tag>(offset));
+      const auto value = static_cast<std::size_t>(elf.template read<Value>(offset + sizeof(Tag)));
 
-      fin.seekg(rel_section.offset);
+      std::string_view name;
+      if((tag == 1 || tag == 14 || tag == 15 || tag == 29) && value < strings.size()) {
+        name = strings.substr(value);
+        name = name.substr(0, name.find('\0'));
+      }
+      entries.push_back({tag, value, name});
 
-      std::vector<std::tuple<std::size_t, std::size_t, std::string_view, std::size_t, std::string>> entries;
+      if(tag == 0) break; // DT_NULL
+    }
+  });
 
-      const auto n_entry = rel_section.size / rel_section.entsize;
-      for(int i = 0; i != n_entry; ++i) {
-        Elf64_Rela_t rel{};
-        fin.read(reinterpret_cast<char *>(&rel), sizeof(decltype(rel)));
+  return entries;
+}
 
-        const std::string_view relocation_type = [&] {
-          if(const auto machine = this->machine(); machine == "AMD x86-64")
-            return amd64_relocation_type(r_sym_64_type(rel.info));
-          else if(machine == "AARCH64") return aarch64_relocation_type(r_sym_64_type(rel.info));
-          else return std::string_view{"Unknown"};
-        }();
+auto FileHeader::relativeRelocationTables() const noexcept -> std::vector<RelrView> {
+  std::vector<RelrView> tables;
 
-        entries.push_back(std::make_tuple(rel.offset, rel.info, relocation_type, 0xabcdef0123, "implement_this"));
-      }
+  visit([&]<typename Elf>(const Elf &elf) {
+    using Section_Header = typename Elf::Section_Header;
+
+    for(const auto &[name, header] : section_headers) {
+      const auto &section = std::get<Section_Header>(header);
+      if(section.type != 19) continue;
 
-      things[std::make_pair(sectionName, rel_section.offset)] = std::move(entries);
+      RelrView &view = tables.emplace_back();
+      view.section_name = name;
+      view.section_offset = section.offset;
+      view.word_size = sizeof(typename Elf::class_type::Addr);
+      view.table = elf.sectionData(section);
     }
-  }
+  });
 
-  return things;
+  return tables;
 }
 
 // clang-format off
@@ -518,50 +1142,272 @@ auto FileHeader::sectionHeaderStringTableIndex() const noexcept -> int {
                                [](const Elf64_Header_t &x64) { return x64.shStringIndex; }}, elf_header);
 }
 
-auto FileHeader::isELF() const noexcept -> bool {
-  const std::array<Elf_byte, 4> identification_bytes{0x7f, 'E', 'L', 'F'};
+auto FileHeader::symbolTableOf(const Section_t *section) const noexcept -> Symbol_Table_t {
+  return visit([&]<typename Elf>(const Elf &elf) -> Symbol_Table_t {
+    using Symbol = typename Elf::Symbol;
+    if(section == nullptr) return TableView<Symbol>{};
+    return elf.template table<Symbol>(std::get<typename Elf::Section_Header>(section->header));
+  });
+}
 
-  fin.seekg(0);
+// Tables are byte-swapped once, in bulk, so walking them later costs the same as for a file in the host's byte order
+void FileHeader::swapTables() {
+  const auto image = bytes();
 
-  std::array<Elf_byte, 4> buf{};
-  fin.read(reinterpret_cast<char *>(buf.data()), std::size(buf) * sizeof(Elf_byte));
+  std::visit(
+      [&]<typename Header>(const Header &elf_header) {
+        using Class = std::conditional_t<std::is_same_v<Header, Elf64_Header_t>, Elf64, Elf32>;
+
+        const auto swap = [&]<typename T>(const std::size_t offset, const std::size_t size, const std::size_t entsize) {
+          if(offset == 0 || size == 0 || offset >= image.size()) return;
+          swapped_tables[offset] =
+              byteswappedTable<T>(image.subspan(offset, std::min(size, image.size() - offset)), entsize);
+        };
+
+        swap.template operator()<typename Class::Program_Header>(
+            elf_header.phOffset, std::size_t{elf_header.phNumber} * elf_header.phEntrySize, elf_header.phEntrySize);
+        swap.template operator()<typename Class::Section_Header>(
+            elf_header.shOffset, std::size_t{elf_header.shNumber} * elf_header.shEntrySize, elf_header.shEntrySize);
+
+        for(const auto &section : section_headers) {
+          const auto &sh = std::get<typename Class::Section_Header>(section.header);
+
+          switch(sh.type) {
+          case 2:  // SYMTAB
+          case 11: swap.template operator()<typename Class::Symbol>(sh.offset, sh.size, sh.entsize); break; // DYNSYM
+          case 4:  swap.template operator()<typename Class::Rela>(sh.offset, sh.size, sh.entsize); break;    // RELA
+          case 9:  swap.template operator()<typename Class::Rel>(sh.offset, sh.size, sh.entsize); break;     // REL
+          case 6:  swap.template operator()<typename Class::Dynamic>(sh.offset, sh.size, sh.entsize); break; // DYNAMIC
+          case 19: swap.template operator()<typename Class::Addr>(sh.offset, sh.size, sh.entsize); break;    // RELR
+          case 5: // HASH, 32-bit words except on a few 64-bit targets
+            if(sh.entsize == 8) swap.template operator()<Elf64_Xword>(sh.offset, sh.size, sh.entsize);
+            else swap.template operator()<Elf32_Word>(sh.offset, sh.size, sizeof(Elf32_Word));
+            break;
+          }
+        }
+      },
+      elf_header);
+}
 
-  return identification_bytes == buf;
+auto FileHeader::swappedTable(const std::size_t offset) const noexcept -> std::optional<std::span<const Elf_byte>> {
+  if(const auto found = swapped_tables.find(offset); found != swapped_tables.end()) return found->second;
+  return std::nullopt;
 }
 
-auto FileHeader::is64bit() const noexcept -> bool {
-  fin.seekg(4);
+SymbolIndex::SymbolIndex(const FileHeader &file) {
+  struct Candidate {
+    std::size_t start;
+    std::size_t end;
+    int rank; // lower wins among aliases
+    std::string_view name;
+  };
+  std::vector<Candidate> candidates;
+
+  file.visit([&](const auto &elf) {
+    const auto collect = [&](const auto &table, const auto &name_of) {
+      for(const auto symbol : table) {
+        const auto type = symbol.info & 0xf;
+        if(type != 1 && type != 2 && type != 10) continue; // OBJECT, FUNC, GNU_IFUNC
+        if(symbol.shndx == 0 || symbol.shndx == 0xfff1 || symbol.shndx == 0xfff2) continue; // UNDEF, ABS, COMMON
+
+        const auto bind = symbol.info >> 4;
+        const int rank = bind == 1 ? 0 : bind == 2 ? 1 : 2; // GLOBAL, WEAK, LOCAL and the rest
+        candidates.push_back({symbol.value, symbol.value + symbol.size, rank, name_of(symbol)});
+      }
+    };
+
+    collect(elf.symbolTable(), [&](const auto &symbol) { return elf.symbolName(symbol); });
+    collect(elf.dynamicSymbolTable(), [&](const auto &symbol) { return elf.dynamicSymbolName(symbol); });
+  });
 
-  Elf_byte temp;
-  fin.read(reinterpret_cast<char *>(&temp), sizeof(Elf_byte));
+  // Symbols of size 0 extend up to the next one
+  std::vector<std::size_t> symbol_starts(candidates.size());
+  std::ranges::transform(candidates, symbol_starts.begin(), &Candidate::start);
+  std::ranges::sort(symbol_starts);
 
-  return temp == 2;
+  for(auto &candidate : candidates) {
+    if(candidate.end != candidate.start) continue;
+    const auto next = std::ranges::upper_bound(symbol_starts, candidate.start);
+    candidate.end = next == symbol_starts.end() ? candidate.start + 1 : *next;
+  }
+
+  // Outer symbols before the ones they contain, the preferred alias first and of equal ones the first in table order
+  std::ranges::stable_sort(candidates, [](const Candidate &lhs, const Candidate &rhs) {
+    if(lhs.start != rhs.start) return lhs.start < rhs.start;
+    if(lhs.end != rhs.end) return lhs.end > rhs.end;
+    return lhs.rank < rhs.rank;
+  });
+
+  // Aliases, and the same symbol seen in both tables, become one
+  const auto duplicates = std::ranges::unique(candidates, [](const Candidate &lhs, const Candidate &rhs) {
+    return lhs.start == rhs.start && lhs.end == rhs.end;
+  });
+  candidates.erase(duplicates.begin(), duplicates.end());
+
+  // Sweep the nested intervals into disjoint ones: the innermost open symbol owns each stretch of addresses
+  std::vector<const Candidate *> enclosing;
+  std::size_t position = 0;
+
+  const auto emit = [&](const std::size_t from, const std::size_t to, const Candidate &symbol) {
+    if(from >= to) return;
+    if(!ranges.empty() && ranges.back().end == from && ranges.back().value == symbol.start &&
+       ranges.back().name.data() == symbol.name.data()) {
+      ranges.back().end = to; // the outer symbol resuming where it left off before a nested one
+      return;
+    }
+    starts.push_back(from);
+    ranges.push_back({to, symbol.start, symbol.name});
+  };
+
+  const auto close = [&] {
+    const auto &symbol = *enclosing.back();
+    emit(std::max(position, symbol.start), symbol.end, symbol);
+    position = std::max(position, symbol.end);
+    enclosing.pop_back();
+  };
+
+  for(const auto &candidate : candidates) {
+    while(!enclosing.empty() && enclosing.back()->end <= candidate.start)
+      close();
+
+    if(!enclosing.empty()) emit(std::max(position, enclosing.back()->start), candidate.start, *enclosing.back());
+    position = std::max(position, candidate.start);
+    enclosing.push_back(&candidate);
+  }
+
+  while(!enclosing.empty())
+    close();
 }
 
-auto FileHeader::getSymbolName(const std::size_t name) const noexcept -> std::string {
-  const auto offset =
-      std::visit(overloaded{[](const Elf32_Section_Header_t &x32) -> std::size_t { return x32.offset; },
-                            [](const Elf64_Section_Header_t &x64) -> std::size_t { return x64.offset; }}, section_headers.find(".strtab")->second);
+auto SymbolIndex::find(const std::size_t address) const noexcept -> std::size_t {
+  if(starts.empty() || address < starts.front()) return ranges.size();
 
-  fin.seekg(offset + name);
+  // Branch free binary search, the loop runs log2(size) times whatever the address
+  const std::size_t *first = starts.data();
+  for(auto length = starts.size(); length > 1;) {
+    const auto half = length / 2;
+    first = first[half] <= address ? first + half : first;
+    length -= half;
+  }
+  return static_cast<std::size_t>(first - starts.data());
+}
 
-  std::string symNameStr;
-  std::getline(fin, symNameStr, '\0');
+void SymbolIndex::lookup(std::span<const std::size_t> addresses, std::span<Symbolized_t> results) const noexcept {
+  const auto count = std::min(addresses.size(), results.size());
 
-  return symNameStr;
+  if(!std::is_sorted(addresses.begin(), addresses.begin() + static_cast<std::ptrdiff_t>(count))) {
+    for(std::size_t i = 0; i != count; ++i)
+      results[i] = lookup(addresses[i]);
+    return;
+  }
+
+  // Each search starts where the previous one ended
+  auto from = starts.begin();
+  for(std::size_t i = 0; i != count; ++i) {
+    from = std::upper_bound(from, starts.end(), addresses[i]);
+    const auto index = from == starts.begin() ? ranges.size() : static_cast<std::size_t>(from - starts.begin()) - 1;
+    results[i] = resolve(index, addresses[i]);
+  }
+}
+
+auto FileHeader::isELF() const noexcept -> bool {
+  const std::array<Elf_byte, 4> identification_bytes{0x7f, 'E', 'L', 'F'};
+
+  const auto image = bytes();
+  return image.size() >= std::size(identification_bytes) &&
+         std::ranges::equal(image.first(std::size(identification_bytes)), identification_bytes);
+}
+
+auto FileHeader::is64bit() const noexcept -> bool {
+  return readAt<Elf_byte>(bytes(), i_class) == 2;
+}
+
+auto FileHeader::getSymbolName(const std::size_t name) const noexcept -> std::string_view {
+  return stringAt(strtab_view, name);
+}
+
+auto FileHeader::getDynamicSymbolName(const std::size_t name) const noexcept -> std::string_view {
+  return stringAt(dynstr_view, name);
+}
+
+auto getFileClass(const Elf_byte classData) noexcept -> std::string_view {
+  switch(classData) {
+  case 0: return "None";  // Invalid class
+  case 1: return "ELF32"; // 32-bit objects, machines with virtual address spaces up to 4Gb
+  case 2: return "ELF64"; // 64-bit objects
+  }
+  return "Unknown";
+}
+
+auto getDataEncoding(const Elf_byte encodingData) noexcept -> std::string_view {
+  switch(encodingData) {
+  case 0: return "None";
+  case 1: return "2's complement, little endian"; // 0x0102 -> 0x02 0x01
+  case 2: return "2's complement, big endian";    // 0x0102 -> 0x01 0x02
+  }
+  return "Unknown";
 }
 
-auto FileHeader::getDynamicSymbolName(const std::size_t name) const noexcept -> std::string {
-  const auto offset =
-      std::visit(overloaded{[](const Elf32_Section_Header_t &x32) -> std::size_t { return x32.offset; },
-                            [](const Elf64_Section_Header_t &x64) -> std::size_t { return x64.offset; }}, section_headers.find(".dynstr")->second);
+auto getOSABI(const Elf_byte osABI) noexcept -> std::string_view {
+  switch(osABI) {
+  case 0: return "UNIX System V ABI";
+  case 1: return "HP-UX";
+  case 2: return "NetBSD";
+  case 3: return "Object uses GNU ELF extensions";
+  // case osabi::linux: return "Compatibility alias";
+  case 6: return "Sun Solaris";
+  case 7: return "IBM AIX";
+  case 8: return "SGI Irix";
+  case 9: return "FreeBSD";
+  case 10: return "Compaq TRU64 UNIX";
+  case 11: return "Novell Modesto";
+  case 12: return "OpenBSD";
+  case 64: return "ARM EABI";
+  case 97: return "ARM";
+  case 255: return "Standalone (embedded) application";
+  }
+  return "Unknown";
+}
 
-  fin.seekg(offset + name);
+auto getFileType(const std::size_t fileType) noexcept -> std::string_view {
+  switch(fileType) {
+  case 0: return "No file type";
+  case 1: return "Relocatible file";
+  case 2: return "Executable file";
+  case 3: return "Shared object file";
+  case 4: return "Core file";
+  }
 
-  std::string dynSymNameStr;
-  std::getline(fin, dynSymNameStr, '\0');
+  if(fileType >= 0xff00 && fileType <= 0xffff) {
+    return "Processor specific";
+  }
+  return "Unknown";
+}
 
-  return dynSymNameStr;
+auto getMachine(const std::size_t machine) noexcept -> std::string_view {
+  switch(machine) {
+  case 0: return "An unknown machine";
+  case 1: return "AT&T WE 32100";
+  case 2: return "Sun Microsystems SPARC";
+  case 3: return "Intel 80386";
+  case 4: return "Motorola 68000";
+  case 5: return "Motorola 88000";
+  case 7: return "Intel 80860";
+  case 8: return "MIPS RS3000 (big-endian only)";
+  case 15: return "HP/PA";
+  case 18: return "SPARC with enhanced instruction set";
+  case 20: return "PowerPC";
+  case 21: return "PowerPC 64-bit";
+  case 22: return "IBM S/390";
+  case 40: return "Advanced RISC Machines";
+  case 42: return "Renesas SuperH";
+  case 43: return "SPARC v9 64-bit";
+  case 50: return "Intel Itanium";
+  case 62: return "AMD x86-64";
+  case 75: return "DEC Vax";
+  case 183: return "AARCH64";
+  }
+  return "Unknown";
 }
 
 auto getProgramHeaderType(const std::size_t phType) noexcept -> std::string_view {
@@ -596,11 +1442,11 @@ auto getProgramHeaderType(const std::size_t phType) noexcept -> std::string_view
   if(phType >= 0x70000000 && phType <= 0x7fff'ffff) { // start-end of processor-specific
     return "processor specific";
   }
+  return "Unknown";
 }
 
-std::string phFlagStr;
-auto getProgramHeaderFlag(const std::size_t phFlag) noexcept -> std::string_view {
-  phFlagStr.clear();
+auto getProgramHeaderFlag(const std::size_t phFlag) noexcept -> std::string {
+  std::string phFlagStr;
 
   if(phFlag & (1 << 0)) phFlagStr.push_back('X');
   if(phFlag & (1 << 1)) phFlagStr.push_back('W');
@@ -608,7 +1454,7 @@ auto getProgramHeaderFlag(const std::size_t phFlag) noexcept -> std::string_view
   // if(phFlags & 0x0ff00000) REVISIT: handle OS-specific
   // if(phFlags & 0xf0000000) REVISIT: handle processor-specific
 
-  return phFlagStr.c_str();
+  return phFlagStr;
 }
 
 auto getSectionHeaderType(const std::size_t shType) noexcept -> std::string_view {
@@ -660,11 +1506,11 @@ auto getSectionHeaderType(const std::size_t shType) noexcept -> std::string_view
   if(shType >= 0x80000000 && shType <= 0x8fffffff) { // [start-end] processor specific
     return "application specific";
   }
+  return "Unknown";
 }
 
-std::string shFlagsStr;
-auto getSectionHeaderFlag(const std::size_t shFlag) noexcept -> std::string_view {
-  shFlagsStr.clear();
+auto getSectionHeaderFlag(const std::size_t shFlag) noexcept -> std::string {
+  std::string shFlagsStr;
   if(shFlag & (1 << 0)) shFlagsStr.push_back('W');    // writable
   if(shFlag & (1 << 1)) shFlagsStr.push_back('A');    // occupies memory during execution
   if(shFlag & (1 << 2)) shFlagsStr.push_back('X');    // executable
@@ -680,7 +1526,92 @@ auto getSectionHeaderFlag(const std::size_t shFlag) noexcept -> std::string_view
   if(shFlag == 0xf0000000) shFlagsStr.push_back('p'); // processor-specific
   if(shFlag & (1 << 30)) shFlagsStr.push_back('?');   // (Revisit '?') special ordering requirement (Solaris)
   if(shFlag & (1 << 31)) shFlagsStr.push_back('E');   // excluded unless referenced or allocated (Solaris)
-  return shFlagsStr.c_str();
+  return shFlagsStr;
+}
+
+auto getDynamicTag(const std::int64_t tag) noexcept -> std::string_view {
+  switch(tag) {
+  case 0:  return "NULL";            // Marks end of dynamic section
+  case 1:  return "NEEDED";          // Name of needed library
+  case 2:  return "PLTRELSZ";        // Size in bytes of PLT relocs
+  case 3:  return "PLTGOT";          // Processor defined value
+  case 4:  return "HASH";            // Address of symbol hash table
+  case 5:  return "STRTAB";          // Address of string table
+  case 6:  return "SYMTAB";          // Address of symbol table
+  case 7:  return "RELA";            // Address of Rela relocs
+  case 8:  return "RELASZ";          // Total size of Rela relocs
+  case 9:  return "RELAENT";         // Size of one Rela reloc
+  case 10: return "STRSZ";           // Size of string table
+  case 11: return "SYMENT";          // Size of one symbol table entry
+  case 12: return "INIT";            // Address of init function
+  case 13: return "FINI";            // Address of termination function
+  case 14: return "SONAME";          // Name of shared object
+  case 15: return "RPATH";           // Library search path (deprecated)
+  case 16: return "SYMBOLIC";        // Start symbol search here
+  case 17: return "REL";             // Address of Rel relocs
+  case 18: return "RELSZ";           // Total size of Rel relocs
+  case 19: return "RELENT";          // Size of one Rel reloc
+  case 20: return "PLTREL";          // Type of reloc in PLT
+  case 21: return "DEBUG";           // For debugging; unspecified
+  case 22: return "TEXTREL";         // Reloc might modify .text
+  case 23: return "JMPREL";          // Address of PLT relocs
+  case 24: return "BIND_NOW";        // Process relocations of object
+  case 25: return "INIT_ARRAY";      // Array with addresses of init fct
+  case 26: return "FINI_ARRAY";      // Array with addresses of fini fct
+  case 27: return "INIT_ARRAYSZ";    // Size in bytes of DT_INIT_ARRAY
+  case 28: return "FINI_ARRAYSZ";    // Size in bytes of DT_FINI_ARRAY
+  case 29: return "RUNPATH";         // Library search path
+  case 30: return "FLAGS";           // Flags for the object being loaded
+  case 32: return "PREINIT_ARRAY";   // Array with addresses of preinit fct
+  case 33: return "PREINIT_ARRAYSZ"; // Size in bytes of DT_PREINIT_ARRAY
+  case 34: return "SYMTAB_SHNDX";    // Address of SYMTAB_SHNDX section
+  case 35: return "RELRSZ";          // Total size of RELR relative relocations
+  case 36: return "RELR";            // Address of RELR relative relocations
+  case 37: return "RELRENT";         // Size of one RELR relative relocation
+
+  case 0x6ffffef5: return "GNU_HASH";   // GNU-style hash table
+  case 0x6ffffff0: return "VERSYM";     // Address of the version symbol table
+  case 0x6ffffff9: return "RELACOUNT";  // Number of relative Rela relocs
+  case 0x6ffffffa: return "RELCOUNT";   // Number of relative Rel relocs
+  case 0x6ffffffb: return "FLAGS_1";    // State flags
+  case 0x6ffffffc: return "VERDEF";     // Address of version definition table
+  case 0x6ffffffd: return "VERDEFNUM";  // Number of version definitions
+  case 0x6ffffffe: return "VERNEED";    // Address of table with needed versions
+  case 0x6fffffff: return "VERNEEDNUM"; // Number of needed versions
+  }
+
+  if(tag >= 0x6000000d && tag <= 0x6ffff000) return "OS specific";
+  if(tag >= 0x70000000 && tag <= 0x7fffffff) return "processor specific";
+  return "Unknown";
+}
+
+auto getNoteType(std::string_view owner, const std::uint32_t type) noexcept -> std::string_view {
+  if(owner == "GNU") {
+    switch(type) {
+    case 1: return "NT_GNU_ABI_TAG";         // OS and ABI version the file is built for
+    case 2: return "NT_GNU_HWCAP";           // Synthetic hwcap information
+    case 3: return "NT_GNU_BUILD_ID";        // Unique build ID bitstring
+    case 4: return "NT_GNU_GOLD_VERSION";    // Version of the gold linker
+    case 5: return "NT_GNU_PROPERTY_TYPE_0"; // Program properties
+    }
+  }
+
+  if(owner == "CORE" || owner == "LINUX") {
+    switch(type) {
+    case 1:          return "NT_PRSTATUS";   // Registers and signal of a thread
+    case 2:          return "NT_FPREGSET";   // Floating point registers
+    case 3:          return "NT_PRPSINFO";   // Process information
+    case 4:          return "NT_TASKSTRUCT"; // Task structure
+    case 6:          return "NT_AUXV";       // Auxiliary vector
+    case 0x202:      return "NT_X86_XSTATE"; // Extended x86 state
+    case 0x46494c45: return "NT_FILE";       // Files mapped by the process
+    case 0x53494749: return "NT_SIGINFO";    // siginfo_t of the signal that dumped the core
+    }
+  }
+
+  if(owner == "stapsdt" && type == 3) return "NT_STAPSDT"; // SystemTap probe
+  if(owner == "FDO" && type == 0xcafe1a7e) return "FDO_PACKAGING_METADATA";
+  return "Unknown";
 }
 
 auto getSymbolType(const Elf_byte symInfo) noexcept -> std::string_view {
@@ -704,6 +1635,7 @@ auto getSymbolType(const Elf_byte symInfo) noexcept -> std::string_view {
   if(symInfo >= 13 && symInfo <= 15) { // [start, end] processor-specific
     return "processor-specific";
   }
+  return "Unknown";
 }
 
 auto getSymbolBind(const Elf_byte symInfo) noexcept -> std::string_view {
@@ -723,6 +1655,7 @@ auto getSymbolBind(const Elf_byte symInfo) noexcept -> std::string_view {
   if(symInfo >= 13 && symInfo <= 15) { // [start, end] processor-specific
     return "";
   }
+  return "Unknown";
 }
 
 auto getSymbolVisibility(const Elf_byte symOther) noexcept -> std::string_view {
@@ -732,6 +1665,7 @@ auto getSymbolVisibility(const Elf_byte symOther) noexcept -> std::string_view {
   case 2: return "HIDDEN";    // sym unavailable in other modules
   case 3: return "PROTECTED"; // not preemptible, not exported
   }
+  return "Unknown";
 }
 
 auto getSymbolIndex(const Elf_byte symIndex) noexcept -> std::string {
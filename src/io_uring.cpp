@@ -0,0 +1,198 @@
+#include "io_uring.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+#if !defined(_WIN32)
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define FEELELF_IO_URING 1
+#include <linux/io_uring.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace feelelf::detail {
+
+namespace {
+constexpr std::int64_t pending = std::numeric_limits<std::int64_t>::min(); // queued in the ring, not completed yet
+
+#if !defined(_WIN32)
+auto preadFully(const int fd, std::span<Elf_byte> buffer, const std::size_t offset) noexcept -> std::int64_t {
+  std::size_t done = 0;
+  while(done != buffer.size()) {
+    const auto n = ::pread(fd, buffer.data() + done, buffer.size() - done, static_cast<off_t>(offset + done));
+    if(n == 0) break;
+    if(n < 0) {
+      if(errno == EINTR) continue;
+      return done == 0 ? -1 : static_cast<std::int64_t>(done);
+    }
+    done += static_cast<std::size_t>(n);
+  }
+  return static_cast<std::int64_t>(done);
+}
+#endif
+
+void readAll(std::span<Ring::Read> reads) noexcept {
+#if !defined(_WIN32)
+  for(auto &read : reads)
+    if(read.result == pending || read.result == -1) read.result = preadFully(read.fd, read.buffer, read.offset);
+#else
+  (void)reads;
+#endif
+}
+} // namespace
+
+#if defined(FEELELF_IO_URING)
+
+Ring::Ring(const unsigned entries) noexcept {
+  io_uring_params params{};
+  const int fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+  if(fd < 0) return;
+
+  sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+
+  // Since 5.4 both rings share one mapping
+  const bool single_mapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if(single_mapping) sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+
+  constexpr int protection = PROT_READ | PROT_WRITE;
+  constexpr int flags = MAP_SHARED | MAP_POPULATE;
+  sq_ring = ::mmap(nullptr, sq_ring_size, protection, flags, fd, IORING_OFF_SQ_RING);
+  cq_ring = single_mapping ? sq_ring : ::mmap(nullptr, cq_ring_size, protection, flags, fd, IORING_OFF_CQ_RING);
+  sqes = ::mmap(nullptr, sqes_size, protection, flags, fd, IORING_OFF_SQES);
+
+  if(sq_ring == MAP_FAILED || cq_ring == MAP_FAILED || sqes == MAP_FAILED) {
+    if(sqes != MAP_FAILED) ::munmap(sqes, sqes_size);
+    if(!single_mapping && cq_ring != MAP_FAILED) ::munmap(cq_ring, cq_ring_size);
+    if(sq_ring != MAP_FAILED) ::munmap(sq_ring, sq_ring_size);
+    ::close(fd);
+    return;
+  }
+
+  auto *sq = static_cast<char *>(sq_ring);
+  auto *cq = static_cast<char *>(cq_ring);
+  sq_head = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+  sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+  sq_mask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+  sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+  cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+  cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+  cq_mask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+  cqes = cq + params.cq_off.cqes;
+
+  ring_fd = fd;
+  this->entries = params.sq_entries;
+}
+
+Ring::~Ring() {
+  close();
+}
+
+void Ring::close() noexcept {
+  if(!valid()) return;
+
+  ::munmap(sqes, sqes_size);
+  if(cq_ring != sq_ring) ::munmap(cq_ring, cq_ring_size);
+  ::munmap(sq_ring, sq_ring_size);
+  ::close(ring_fd);
+  ring_fd = -1;
+}
+
+void Ring::reap(std::span<Read> reads, std::size_t &in_flight) noexcept {
+  const auto *completions = static_cast<const io_uring_cqe *>(cqes);
+
+  unsigned head = *cq_head;
+  const unsigned tail = std::atomic_ref{*cq_tail}.load(std::memory_order_acquire);
+  for(; head != tail; ++head, --in_flight) {
+    const auto &cqe = completions[head & *cq_mask];
+    auto &read = reads[cqe.user_data];
+
+    // A failed read, e.g. -EINVAL from kernels without IORING_OP_READ, is done again with pread, and so is the rest of
+    // a short one
+    const auto size = static_cast<std::int64_t>(read.buffer.size());
+    if(cqe.res < 0) read.result = preadFully(read.fd, read.buffer, read.offset);
+    else if(cqe.res == 0 || cqe.res == size) read.result = cqe.res;
+    else {
+      const auto done = static_cast<std::size_t>(cqe.res);
+      read.result =
+          cqe.res + std::max<std::int64_t>(preadFully(read.fd, read.buffer.subspan(done), read.offset + done), 0);
+    }
+  }
+  std::atomic_ref{*cq_head}.store(head, std::memory_order_release);
+}
+
+void Ring::run(std::span<Read> reads) noexcept {
+  if(!valid()) {
+    readAll(reads);
+    return;
+  }
+
+  auto *submissions = static_cast<io_uring_sqe *>(sqes);
+
+  std::size_t next = 0;      // first read not queued yet
+  unsigned queued = 0;       // queued, not submitted yet
+  std::size_t in_flight = 0; // queued or submitted, not completed yet
+
+  while(next != reads.size() || in_flight != 0) {
+    for(; next != reads.size() && in_flight != entries; ++next, ++queued, ++in_flight) {
+      auto &read = reads[next];
+      read.result = pending;
+
+      const unsigned tail = *sq_tail;
+      const unsigned index = tail & *sq_mask;
+      auto &sqe = submissions[index];
+      sqe = {};
+      sqe.opcode = IORING_OP_READ;
+      sqe.fd = read.fd;
+      sqe.addr = reinterpret_cast<std::uintptr_t>(read.buffer.data());
+      sqe.len = static_cast<unsigned>(read.buffer.size());
+      sqe.off = read.offset;
+      sqe.user_data = next;
+      sq_array[index] = index;
+      std::atomic_ref{*sq_tail}.store(tail + 1, std::memory_order_release);
+    }
+
+    const auto submitted = ::syscall(__NR_io_uring_enter, ring_fd, queued, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+    if(submitted < 0) {
+      if(errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+
+      // The ring is unusable. The kernel took none of the reads queued, they are taken back. Those it holds may still
+      // be written to their buffers, so they are waited for before pread is given the buffers and the ring is closed
+      std::atomic_ref{*sq_tail}.store(*sq_tail - queued, std::memory_order_release);
+      in_flight -= queued;
+      while(in_flight != 0) {
+        if(::syscall(__NR_io_uring_enter, ring_fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0)
+          ::sched_yield(); // completions are still posted on the way out of any system call
+        reap(reads, in_flight);
+      }
+      close();
+      break; // what is left is read with pread below
+    }
+    queued -= static_cast<unsigned>(submitted);
+    reap(reads, in_flight);
+  }
+
+  readAll(reads);
+}
+
+#else
+
+Ring::Ring(unsigned) noexcept {}
+
+Ring::~Ring() = default;
+
+void Ring::run(std::span<Read> reads) noexcept {
+  readAll(reads);
+}
+
+#endif
+
+} // namespace feelelf::detail
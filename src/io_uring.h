@@ -0,0 +1,66 @@
+#pragma once
+
+#include <feelelf/feelelf.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace feelelf::detail {
+
+// Reads of many files submitted together through io_uring, set up with the raw system calls so there is no dependency
+// on liburing. Where io_uring is unavailable (not Linux, kernels before 5.1, or forbidden by a seccomp policy)
+// valid() is false and run() falls back to pread
+class Ring {
+  int ring_fd = -1;
+  unsigned entries = 0;
+
+  void *sq_ring = nullptr;
+  void *cq_ring = nullptr;
+  void *sqes = nullptr;
+  std::size_t sq_ring_size = 0;
+  std::size_t cq_ring_size = 0;
+  std::size_t sqes_size = 0;
+
+  // Offsets of the ring fields in the mappings, as the kernel reports them
+  unsigned *sq_head = nullptr;
+  unsigned *sq_tail = nullptr;
+  unsigned *sq_mask = nullptr;
+  unsigned *sq_array = nullptr;
+  unsigned *cq_head = nullptr;
+  unsigned *cq_tail = nullptr;
+  unsigned *cq_mask = nullptr;
+  void *cqes = nullptr;
+
+public:
+  struct Read {
+    int fd;
+    std::span<Elf_byte> buffer;
+    std::size_t offset;
+    std::size_t index;        // for the caller to tell reads apart
+    std::int64_t result = -1; // bytes read, fewer at the end of the file, -1 on errors
+  };
+
+  explicit Ring(unsigned entries) noexcept;
+  Ring(const Ring &) = delete;
+  auto operator=(const Ring &) -> Ring & = delete;
+  ~Ring();
+
+  [[nodiscard]] auto valid() const noexcept -> bool {
+    return ring_fd != -1;
+  }
+
+  // Performs every read and returns once all are done, as many in flight at once as the ring holds. A read the ring
+  // fails to do is done again with pread, as they all are when the ring isn't valid. If the kernel refuses the ring
+  // itself, the reads it holds are waited for, the ring is closed, and this and later runs read with pread
+  void run(std::span<Read> reads) noexcept;
+
+private:
+  // Takes the completions the kernel posted, completed reads are counted off in_flight
+  void reap(std::span<Read> reads, std::size_t &in_flight) noexcept;
+
+  // Unmaps the rings and closes the ring, valid() is false after
+  void close() noexcept;
+};
+
+} // namespace feelelf::detail
@@ -0,0 +1,182 @@
+#include <feelelf/process.h>
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <variant>
+
+namespace feelelf {
+
+namespace {
+template <typename T>
+auto parseNumber(std::string_view &text, T &value, const int base) noexcept -> bool {
+  const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value, base);
+  if(error != std::errc{}) return false;
+  text.remove_prefix(static_cast<std::size_t>(end - text.data()));
+  return true;
+}
+
+auto skip(std::string_view &text, const char c) noexcept -> bool {
+  if(text.empty() || text.front() != c) return false;
+  text.remove_prefix(1);
+  return true;
+}
+
+void skipSpaces(std::string_view &text) noexcept {
+  while(!text.empty() && text.front() == ' ')
+    text.remove_prefix(1);
+}
+
+// "start-end perms offset major:minor inode path", all hex except the inode
+auto parseMapping(std::string_view line, Mapping_t &mapping) -> bool {
+  std::uint64_t major = 0;
+  std::uint64_t minor = 0;
+
+  if(!parseNumber(line, mapping.start, 16) || !skip(line, '-') || !parseNumber(line, mapping.end, 16)) return false;
+
+  skipSpaces(line);
+  line.remove_prefix(std::min(line.find(' '), line.size())); // permissions
+  skipSpaces(line);
+
+  if(!parseNumber(line, mapping.offset, 16)) return false;
+  skipSpaces(line);
+  if(!parseNumber(line, major, 16) || !skip(line, ':') || !parseNumber(line, minor, 16)) return false;
+  skipSpaces(line);
+  if(!parseNumber(line, mapping.inode, 10)) return false;
+  skipSpaces(line);
+
+  mapping.device = major << 32 | minor;
+  mapping.path = line;
+  return mapping.inode != 0 && line.starts_with('/'); // anonymous mappings, the heap and the stack have no inode
+}
+} // namespace
+
+auto readProcessMaps(const int pid) -> std::vector<Mapping_t> {
+  std::vector<Mapping_t> mappings;
+
+  std::ifstream maps{"/proc/" + std::to_string(pid) + "/maps"};
+  for(std::string line; std::getline(maps, line);) {
+    Mapping_t mapping{};
+    if(parseMapping(line, mapping)) mappings.push_back(std::move(mapping));
+  }
+
+  // The kernel lists them in address order already
+  return mappings;
+}
+
+// An opened ELF file, with the PT_LOAD segments that map file offsets to link time addresses
+struct ProcessSymbolizer::Object {
+  struct Load {
+    std::size_t offset;
+    std::size_t size;
+    std::size_t vaddr;
+  };
+
+  FileHeader file;
+  SymbolIndex index;
+  std::vector<Load> loads; // sorted by offset
+
+  // Link time address of the byte at offset in the file, false if no PT_LOAD segment maps it
+  [[nodiscard]] auto address(const std::size_t offset, std::size_t &vaddr) const noexcept -> bool {
+    auto load = std::ranges::upper_bound(loads, offset, {}, &Load::offset);
+    if(load == loads.begin()) return false;
+    --load;
+    if(offset - load->offset >= load->size) return false;
+
+    vaddr = load->vaddr + (offset - load->offset);
+    return true;
+  }
+};
+
+ProcessSymbolizer::ProcessSymbolizer(const std::size_t capacity) : capacity{std::max<std::size_t>(capacity, 1)} {}
+
+ProcessSymbolizer::~ProcessSymbolizer() = default;
+
+auto ProcessSymbolizer::entry(const Mapping_t &mapping) -> const Entry & {
+  const Key key{mapping.device, mapping.inode};
+
+  if(const auto it = cached.find(key); it != cached.end()) {
+    recently_used.splice(recently_used.begin(), recently_used, it->second);
+    return *it->second;
+  }
+
+  auto object = std::make_unique<Object>();
+  if(object->file.open(mapping.path.c_str())) {
+    object->file.decode();
+    object->index = SymbolIndex{object->file};
+
+    for(const auto &ph : object->file.programHeaders()) {
+      std::visit(
+          [&](const auto &x) {
+            if(x.type == 1) object->loads.push_back({x.offset, x.filesz, x.vaddr}); // PT_LOAD
+          },
+          ph);
+    }
+    std::ranges::sort(object->loads, {}, &Object::Load::offset);
+  } else {
+    object.reset();
+  }
+
+  recently_used.push_front({key, mapping.path, std::move(object)});
+  cached.emplace(key, recently_used.begin());
+  return recently_used.front();
+}
+
+void ProcessSymbolizer::evict() {
+  while(cached.size() > capacity) {
+    cached.erase(recently_used.back().key);
+    recently_used.pop_back();
+  }
+}
+
+void ProcessSymbolizer::symbolize(const int pid, std::span<const std::size_t> addresses,
+                                  std::span<Process_Symbolized_t> results) {
+  // Objects are closed here rather than as soon as there are too many, names handed out by the previous call stay
+  // valid until now, and a call touching more files than the capacity keeps them all open while it runs
+  evict();
+
+  const auto count = std::min(addresses.size(), results.size());
+  const auto mappings = readProcessMaps(pid);
+
+  // Addresses are translated one by one, then looked up in one batch per object
+  std::unordered_map<const Object *, std::vector<std::size_t>> by_object; // positions in addresses
+
+  for(std::size_t i = 0; i != count; ++i) {
+    results[i] = {};
+
+    const auto address = addresses[i];
+    auto mapping = std::ranges::upper_bound(mappings, address, {}, &Mapping_t::start);
+    if(mapping == mappings.begin()) continue;
+    --mapping;
+    if(address >= mapping->end) continue;
+
+    const auto &entry = this->entry(*mapping);
+    results[i].module = entry.path;
+    if(!entry.object || !entry.object->address(address - mapping->start + mapping->offset, results[i].address))
+      continue;
+
+    by_object[entry.object.get()].push_back(i);
+  }
+
+  std::vector<std::size_t> batch;
+  std::vector<Symbolized_t> symbolized;
+  for(const auto &[object, positions] : by_object) {
+    batch.clear();
+    for(const auto i : positions)
+      batch.push_back(results[i].address);
+
+    symbolized.resize(batch.size());
+    object->index.lookup(batch, symbolized);
+
+    for(std::size_t j = 0; j != positions.size(); ++j) {
+      results[positions[j]].name = symbolized[j].name;
+      results[positions[j]].offset = symbolized[j].offset;
+    }
+  }
+}
+
+} // namespace feelelf